@@ -0,0 +1,145 @@
+/**
+ * @file artifact_benchmark.cpp
+ * @brief Cost of artifact recognition and the analytical lap estimate
+ *
+ * Builds a track from straights, curves, an S-curve, a chicane, a hairpin,
+ * a spiral and an irregular section, recognizes its artifacts and times
+ * PatternRecognizer::recognizeArtifacts and Artifacts::estimateTrack,
+ * together and per artifact.
+ */
+
+#include "../include/pattern_recognizer.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/artifacts/artifact_factory.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace LineFollower;
+
+namespace {
+
+const float SPACING = 0.01f;    // point spacing (m)
+const int REPEATS = 20;
+
+/**
+ * @brief Piece of track with curvature linear from k0 to k1 (1/m)
+ */
+struct Piece {
+    float length;
+    float k0;
+    float k1;
+};
+
+/**
+ * @brief Points of a track integrated from its curvature pieces
+ */
+std::vector<TrackPoint> buildTrack(const std::vector<Piece>& pieces) {
+    std::vector<TrackPoint> points = {{0.0f, 0.0f}};
+    float x = 0.0f;
+    float y = 0.0f;
+    float heading = 0.0f;
+    for (const Piece& piece : pieces) {
+        int steps = std::max(1, static_cast<int>(std::round(piece.length / SPACING)));
+        float ds = piece.length / static_cast<float>(steps);
+        for (int i = 0; i < steps; i++) {
+            float t = (static_cast<float>(i) + 0.5f) / static_cast<float>(steps);
+            heading += (piece.k0 + (piece.k1 - piece.k0) * t) * ds;
+            x += ds * std::cos(heading);
+            y += ds * std::sin(heading);
+            points.push_back({x, y});
+        }
+    }
+    return points;
+}
+
+RobotConfig makeConfig() {
+    RobotConfig config;
+    config.mass = 0.5f;
+    config.wheelbase = 0.15f;
+    config.wheelDiameter = 0.065f;
+    config.maxSpeed = 2.0f;
+    config.sensorCount = 5;
+    config.sensorSpacing = 0.02f;
+    config.sensorHeight = 0.01f;
+    config.kp = 2.0f;
+    config.ki = 0.1f;
+    config.kd = 0.05f;
+    config.temperature = 25.0f;
+    config.frictionCoeff = 0.8f;
+    config.gravity = 9.81f;
+    return config;
+}
+
+double elapsedMicros(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Median of REPEATS timings of fn (us)
+ */
+template <typename Fn>
+double medianMicros(Fn fn) {
+    std::vector<double> times;
+    for (int i = 0; i < REPEATS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        times.push_back(elapsedMicros(start));
+    }
+    std::nth_element(times.begin(), times.begin() + REPEATS / 2, times.end());
+    return times[REPEATS / 2];
+}
+
+} // namespace
+
+int main() {
+    const float quarter = 0.5f * Physics::PI;
+    std::vector<Piece> pieces = {
+        {1.0f, 0.0f, 0.0f},
+        {0.5f * quarter, 2.0f, 2.0f},                   // 90 deg, R 0.5
+        {0.8f, 0.0f, 0.0f},
+        {0.4f * quarter, 2.5f, 2.5f},                   // S-curve
+        {0.4f * quarter, -2.5f, -2.5f},
+        {0.8f, 0.0f, 0.0f},
+        {0.25f, 4.0f, 4.0f},                            // chicane
+        {0.25f, -4.0f, -4.0f},
+        {0.25f, 4.0f, 4.0f},
+        {0.8f, 0.0f, 0.0f},
+        {0.2f * Physics::PI, 5.0f, 5.0f},               // hairpin, R 0.2
+        {1.0f, 0.0f, 0.0f},
+        {1.0f, 0.2f, 5.0f},                             // spiral
+        {0.8f, 0.0f, 0.0f},
+        {0.3f, 1.0f, 6.0f},                             // irregular
+        {0.3f, 6.0f, 0.5f},
+        {0.3f, 0.5f, 5.0f},
+        {1.0f, 0.0f, 0.0f},
+    };
+    std::vector<TrackPoint> points = buildTrack(pieces);
+    RobotConfig config = makeConfig();
+
+    PatternRecognizer recognizer;
+    CompiledTrack track(points);
+    std::vector<Artifact> artifacts = recognizer.recognizeArtifacts(track);
+    Artifacts::TrackEstimate estimate = Artifacts::estimateTrack(artifacts, config, points);
+
+    std::printf("%zu points, %.2f m, %zu artifacts, estimated lap %.3f s\n",
+                points.size(), track.length(), artifacts.size(), estimate.totalTime);
+
+    double recognizeUs = medianMicros([&] { recognizer.recognizeArtifacts(track); });
+    double estimateUs = medianMicros([&] { Artifacts::estimateTrack(artifacts, config, points); });
+    std::printf("recognizeArtifacts %10.1f us\n", recognizeUs);
+    std::printf("estimateTrack      %10.1f us\n\n", estimateUs);
+
+    // One artifact at a time, as estimateTrack's two passes see it
+    std::printf("%-44s %10s %10s\n", "artifact", "time (s)", "us");
+    for (size_t i = 0; i < artifacts.size(); i++) {
+        std::vector<Artifact> single = {artifacts[i]};
+        double us = medianMicros([&] { Artifacts::estimateTrack(single, config, points); });
+        std::printf("%-44s %10.3f %10.1f\n", artifacts[i].description.c_str(), estimate.strategies[i].estimatedTime, us);
+    }
+
+    return 0;
+}
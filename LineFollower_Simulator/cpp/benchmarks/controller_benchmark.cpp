@@ -0,0 +1,96 @@
+/**
+ * @file controller_benchmark.cpp
+ * @brief Lap time and per-tick cost of the PID against the MPC
+ *
+ * Drives the same robot around the same track with the PID, the MPC under
+ * its default time budget and the MPC limited only by its iteration cap,
+ * and reports each lap time against the minimum-time profile's bound.
+ */
+
+#include "../include/simulator.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/velocity_profile.hpp"
+#include "../include/optimizers/mpc.hpp"
+#include "../include/physics.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace LineFollower;
+
+namespace {
+
+/**
+ * @brief Closed ellipse with the given semi-axes (m)
+ */
+std::vector<TrackPoint> makeTrack(int pointCount, float a, float b) {
+    std::vector<TrackPoint> points;
+    for (int i = 0; i <= pointCount; i++) {
+        float t = 2.0f * Physics::PI * static_cast<float>(i) / static_cast<float>(pointCount);
+        points.push_back({a * std::cos(t), b * std::sin(t)});
+    }
+    return points;
+}
+
+RobotConfig makeConfig() {
+    RobotConfig config;
+    config.mass = 0.5f;
+    config.wheelbase = 0.15f;
+    config.wheelDiameter = 0.065f;
+    config.maxSpeed = 2.0f;
+    config.sensorCount = 5;
+    config.sensorSpacing = 0.02f;
+    config.sensorHeight = 0.01f;
+    config.kp = 2.0f;
+    config.ki = 0.1f;
+    config.kd = 0.05f;
+    config.temperature = 25.0f;
+    config.frictionCoeff = 0.8f;
+    config.gravity = 9.81f;
+    return config;
+}
+
+} // namespace
+
+int main() {
+    const float dt = 0.005f;
+    const float maxTime = 30.0f;
+
+    RobotConfig config = makeConfig();
+    auto track = std::make_shared<const CompiledTrack>(makeTrack(400, 2.0f, 1.0f));
+
+    VelocityProfile profile;
+    profile.compute(*track, VelocityLimits::fromConfig(config));
+    std::printf("track %.2f m, lap time bound %.3f s\n", track->length(), profile.lapTime());
+    std::printf("%-14s %10s %10s %12s %10s\n", "controller", "lap (s)", "vs bound", "us/tick", "fallbacks");
+
+    const char* names[] = {"pid", "mpc", "mpc-no-budget"};
+    for (int mode = 0; mode < 3; mode++) {
+        Simulator simulator(config, track);
+        simulator.initialize();
+        if (mode > 0) {
+            Optimizers::MPCSettings settings = Optimizers::MPCSettings::defaults();
+            if (mode == 2) {
+                settings.budgetMicros = 0.0f;
+            }
+            simulator.enableMPC(settings);
+            simulator.reset();
+        }
+
+        int ticks = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (!simulator.isComplete() && !simulator.hasFailed() && simulator.getCurrentState().time < maxTime) {
+            simulator.step(dt);
+            ticks++;
+        }
+        double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        float lap = simulator.getCompletionTime();
+        std::printf("%-14s %10.3f %10.3f %12.2f %10d\n",
+                    names[mode], lap, lap / profile.lapTime(), micros / ticks, simulator.getMPCFallbacks());
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file population_benchmark.cpp
+ * @brief Candidate evaluations per second against thread count
+ *
+ * Runs the same population of PID configurations to completion or early
+ * abort on a ThreadPool of increasing size, the way
+ * Optimizer::evaluatePopulation does, and reports throughput and speedup.
+ * Run times differ widely between candidates, which exercises stealing.
+ * Finally the whole population runs once more in a SimulatorBatch, which
+ * must reproduce the per-candidate results; the exit status is nonzero if
+ * it does not.
+ */
+
+#include "../include/simulator.hpp"
+#include "../include/simulator_batch.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/thread_pool.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace LineFollower;
+
+namespace {
+
+// Relative difference tolerated between batch and scalar metrics
+constexpr float PARITY_TOLERANCE = 1e-4f;
+
+/**
+ * @brief Closed ellipse with the given semi-axes (m)
+ */
+std::vector<TrackPoint> makeTrack(int pointCount, float a, float b) {
+    std::vector<TrackPoint> points;
+    for (int i = 0; i <= pointCount; i++) {
+        float t = 2.0f * Physics::PI * static_cast<float>(i) / static_cast<float>(pointCount);
+        points.push_back({a * std::cos(t), b * std::sin(t)});
+    }
+    return points;
+}
+
+RobotConfig makeConfig(float kp) {
+    RobotConfig config;
+    config.mass = 0.5f;
+    config.wheelbase = 0.15f;
+    config.wheelDiameter = 0.065f;
+    config.maxSpeed = 1.0f;
+    config.sensorCount = 5;
+    config.sensorSpacing = 0.02f;
+    config.sensorHeight = 0.01f;
+    config.kp = kp;
+    config.ki = 0.1f;
+    config.kd = 0.05f;
+    config.temperature = 25.0f;
+    config.frictionCoeff = 0.8f;
+    config.gravity = 9.81f;
+    return config;
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool nearlyEqual(float a, float b) {
+    return std::abs(a - b) <= PARITY_TOLERANCE * std::max(1.0f, std::max(std::abs(a), std::abs(b)));
+}
+
+} // namespace
+
+int main() {
+    const int populationSize = 64;
+    const float dt = 0.001f;
+
+    auto track = std::make_shared<const CompiledTrack>(makeTrack(400, 2.0f, 1.0f));
+    std::vector<RobotConfig> population;
+    for (int i = 0; i < populationSize; i++) {
+        population.push_back(makeConfig(0.25f + 4.0f * static_cast<float>(i) / populationSize));
+    }
+
+    int hardwareThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    std::printf("population %d, %d hardware threads\n", populationSize, hardwareThreads);
+    std::printf("%8s %12s %10s %10s\n", "threads", "evals/s", "speedup", "complete");
+
+    // Per-candidate results of the last run, for the batch comparison
+    std::vector<float> completion(populationSize);
+    std::vector<float> trackError(populationSize);
+    std::vector<float> energy(populationSize);
+    std::vector<char> failed(populationSize);
+
+    double baseline = 0.0;
+    for (int threads = 1; threads <= hardwareThreads; threads *= 2) {
+        ThreadPool pool(threads);
+
+        auto start = std::chrono::steady_clock::now();
+        pool.parallelFor(populationSize, [&](int i) {
+            Simulator simulator(population[i], track);
+            simulator.initialize();
+            float error = 0.0f;
+            float work = 0.0f;
+            while (!simulator.isComplete() && !simulator.hasFailed()) {
+                simulator.step(dt);
+                error += std::abs(simulator.getCurrentState().lineError) * dt;
+                work += simulator.getCurrentState().power * dt;
+            }
+            completion[i] = simulator.getCompletionTime();
+            trackError[i] = error;
+            energy[i] = work;
+            failed[i] = simulator.hasFailed() ? 1 : 0;
+        });
+        double seconds = elapsedSeconds(start);
+
+        int complete = 0;
+        for (float time : completion) {
+            complete += time >= 0.0f ? 1 : 0;
+        }
+
+        double rate = populationSize / seconds;
+        if (threads == 1) {
+            baseline = rate;
+        }
+        std::printf("%8d %12.1f %10.2f %10d\n", threads, rate, rate / baseline, complete);
+
+        if (threads < hardwareThreads && threads * 2 > hardwareThreads) {
+            threads = hardwareThreads / 2;   // always finish on the full machine
+        }
+    }
+
+    SimulatorBatch batch(population, track);
+    batch.initialize();
+    auto start = std::chrono::steady_clock::now();
+    while (!batch.isDone()) {
+        batch.step(dt);
+    }
+    double seconds = elapsedSeconds(start);
+
+    int mismatches = 0;
+    for (int i = 0; i < populationSize; i++) {
+        bool same = batch.hasFailed(i) == (failed[i] != 0)
+            && nearlyEqual(batch.isComplete(i) ? batch.getCompletionTime(i) : -1.0f, completion[i])
+            && nearlyEqual(batch.getTrackError(i), trackError[i])
+            && nearlyEqual(batch.getEnergy(i), energy[i]);
+        mismatches += same ? 0 : 1;
+    }
+    std::printf("batch: %.1f evals/s on one thread, %d of %d differ from scalar\n",
+        populationSize / seconds, mismatches, populationSize);
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file racing_line_benchmark.cpp
+ * @brief Racing line solve time and apex offset against track density
+ *
+ * Samples the same stadium (1 m straights, 0.3 m radius ends) at
+ * increasing point counts and solves the minimum-curvature racing line
+ * through both ends with ArtifactBase::calculateRacingLines. The apex
+ * offset should not depend on the sampling; the time should stay well
+ * under a second at 10k points.
+ */
+
+#include "../include/artifacts/artifact_base.hpp"
+#include "../include/thread_pool.hpp"
+#include "../include/physics.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace LineFollower;
+
+namespace {
+
+const float STRAIGHT = 1.0f;
+const float RADIUS = 0.3f;
+const float HALF_WIDTH = 0.05f;
+
+/**
+ * @brief Point at arc length s of the stadium, starting mid-way along the
+ *        bottom straight and running anticlockwise
+ */
+TrackPoint stadiumPoint(float s) {
+    float arc = Physics::PI * RADIUS;
+    float half = 0.5f * STRAIGHT;
+    if (s < half) {
+        return {s, -RADIUS};
+    }
+    s -= half;
+    if (s < arc) {
+        float a = s / RADIUS - 0.5f * Physics::PI;
+        return {half + RADIUS * std::cos(a), RADIUS * std::sin(a)};
+    }
+    s -= arc;
+    if (s < STRAIGHT) {
+        return {half - s, RADIUS};
+    }
+    s -= STRAIGHT;
+    if (s < arc) {
+        float a = s / RADIUS + 0.5f * Physics::PI;
+        return {-half + RADIUS * std::cos(a), RADIUS * std::sin(a)};
+    }
+    s -= arc;
+    return {-half + s, -RADIUS};
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+    const int sizes[] = {800, 4000, 10000, 40000};
+    const float length = 2.0f * STRAIGHT + 2.0f * Physics::PI * RADIUS;
+    ThreadPool pool;
+
+    std::printf("%8s %10s %12s\n", "points", "ms", "apex (m)");
+
+    for (int size : sizes) {
+        std::vector<TrackPoint> points;
+        for (int i = 0; i <= size; i++) {
+            points.push_back(stadiumPoint(length * static_cast<float>(i) / static_cast<float>(size)));
+        }
+
+        // One artifact per end, from straight middle to straight middle
+        std::vector<Artifact> artifacts(2);
+        artifacts[0].type = ArtifactType::CIRCULAR_CURVE;
+        artifacts[0].startIndex = 0;
+        artifacts[0].endIndex = size / 2;
+        artifacts[1].type = ArtifactType::CIRCULAR_CURVE;
+        artifacts[1].startIndex = size / 2;
+        artifacts[1].endIndex = size;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::vector<TrackPoint>> lines =
+            Artifacts::ArtifactBase::calculateRacingLines(artifacts, points, HALF_WIDTH, pool);
+        double ms = 1e3 * elapsedSeconds(start);
+
+        // Apex at the middle of the first end
+        float apexArc = 0.5f * STRAIGHT + 0.5f * Physics::PI * RADIUS;
+        int apex = static_cast<int>(std::round(apexArc / length * static_cast<float>(size)));
+        float dx = lines[0][apex].x - points[apex].x;
+        float dy = lines[0][apex].y - points[apex].y;
+
+        std::printf("%8d %10.2f %12.4f\n", size, ms, std::sqrt(dx * dx + dy * dy));
+    }
+
+    return 0;
+}
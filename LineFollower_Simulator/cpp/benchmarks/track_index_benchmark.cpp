@@ -0,0 +1,107 @@
+/**
+ * @file track_index_benchmark.cpp
+ * @brief Compares TrackIndex queries against a brute-force polyline scan
+ *
+ * Builds large synthetic tracks and times sensor-style distance queries
+ * (points within a few centimetres of the line, moving along it) for both
+ * methods, checking that they agree.
+ */
+
+#include "../include/track_index.hpp"
+#include "../include/physics.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace LineFollower;
+
+namespace {
+
+/**
+ * @brief Closed wavy loop with the given number of points (~1 cm spacing)
+ */
+std::vector<TrackPoint> makeTrack(int pointCount) {
+    std::vector<TrackPoint> points;
+    float radius = 0.01f * static_cast<float>(pointCount) / (2.0f * Physics::PI);
+    for (int i = 0; i <= pointCount; i++) {
+        float a = 2.0f * Physics::PI * static_cast<float>(i) / static_cast<float>(pointCount);
+        float r = radius * (1.0f + 0.15f * std::sin(12.0f * a));
+        points.push_back({r * std::cos(a), r * std::sin(a)});
+    }
+    return points;
+}
+
+float bruteForceDistance(const std::vector<TrackPoint>& points, float x, float y, float maxDistance) {
+    float best = maxDistance * maxDistance;
+    float t;
+    for (size_t i = 0; i + 1 < points.size(); i++) {
+        const TrackPoint& a = points[i];
+        const TrackPoint& b = points[i + 1];
+        best = std::min(best, Physics::pointSegmentDistanceSq(x, y, a.x, a.y, b.x, b.y, t));
+    }
+    return std::sqrt(best);
+}
+
+double elapsedSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main() {
+    const int sizes[] = {500, 5000, 20000, 50000};
+    const float sensorRange = Physics::sensorRange(0.01f);
+
+    std::printf("%8s %14s %14s %10s\n", "points", "brute ns/q", "grid ns/q", "max diff");
+
+    for (int size : sizes) {
+        std::vector<TrackPoint> points = makeTrack(size);
+        TrackIndex index;
+        index.build(points);
+
+        // Sensor-like queries: walk along the track with lateral offsets
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> offset(-0.06f, 0.06f);
+        const int queryCount = 20000;
+        std::vector<float> qx(queryCount), qy(queryCount);
+        for (int q = 0; q < queryCount; q++) {
+            int segment = static_cast<int>(static_cast<long>(q) * (size - 1) / queryCount);
+            const TrackPoint& a = points[segment];
+            const TrackPoint& b = points[segment + 1];
+            float dx = b.x - a.x, dy = b.y - a.y;
+            float len = std::sqrt(dx * dx + dy * dy);
+            float o = offset(rng);
+            qx[q] = a.x - dy / len * o;
+            qy[q] = a.y + dx / len * o;
+        }
+
+        // Brute force is slow on large tracks; time a subset
+        int bruteCount = std::min(queryCount, 20000000 / size);
+        std::vector<float> reference(bruteCount);
+        auto start = std::chrono::steady_clock::now();
+        for (int q = 0; q < bruteCount; q++) {
+            reference[q] = bruteForceDistance(points, qx[q], qy[q], sensorRange);
+        }
+        double bruteNs = 1e9 * elapsedSeconds(start) / bruteCount;
+
+        float maxDiff = 0.0f;
+        float sink = 0.0f;
+        start = std::chrono::steady_clock::now();
+        for (int q = 0; q < queryCount; q++) {
+            sink += index.distance(qx[q], qy[q], sensorRange);
+        }
+        double gridNs = 1e9 * elapsedSeconds(start) / queryCount;
+
+        for (int q = 0; q < bruteCount; q++) {
+            float d = index.distance(qx[q], qy[q], sensorRange);
+            maxDiff = std::max(maxDiff, std::abs(d - reference[q]));
+        }
+
+        std::printf("%8d %14.1f %14.1f %10.2e%s\n",
+                    size, bruteNs, gridNs, maxDiff, sink < 0.0f ? " " : "");
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/**
+ * @file track_memory_benchmark.cpp
+ * @brief Resident memory of many simulators on one track
+ *
+ * Creates growing numbers of initialized simulators, either sharing one
+ * compiled track or each compiling its own from the point list, and reports
+ * the process resident set size. Shared simulators should stay flat; private
+ * ones grow with the track size times the candidate count.
+ */
+
+#include "../include/simulator.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/physics.hpp"
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+
+using namespace LineFollower;
+
+namespace {
+
+/**
+ * @brief Closed wavy loop with the given number of points (~1 cm spacing)
+ */
+std::vector<TrackPoint> makeTrack(int pointCount) {
+    std::vector<TrackPoint> points;
+    float radius = 0.01f * static_cast<float>(pointCount) / (2.0f * Physics::PI);
+    for (int i = 0; i <= pointCount; i++) {
+        float a = 2.0f * Physics::PI * static_cast<float>(i) / static_cast<float>(pointCount);
+        float r = radius * (1.0f + 0.15f * std::sin(12.0f * a));
+        points.push_back({r * std::cos(a), r * std::sin(a)});
+    }
+    return points;
+}
+
+RobotConfig makeConfig() {
+    RobotConfig config;
+    config.mass = 0.5f;
+    config.wheelbase = 0.15f;
+    config.wheelDiameter = 0.04f;
+    config.maxSpeed = 1.5f;
+    config.sensorCount = 8;
+    config.sensorSpacing = 0.01f;
+    config.sensorHeight = 0.005f;
+    config.kp = 2.0f;
+    config.ki = 0.0f;
+    config.kd = 0.1f;
+    config.temperature = 25.0f;
+    config.frictionCoeff = 0.8f;
+    config.gravity = 9.81f;
+    return config;
+}
+
+/**
+ * @brief Resident set size in MiB (Linux /proc; 0 elsewhere)
+ */
+double residentMiB() {
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0.0;
+    }
+    long size = 0, resident = 0;
+    int fields = std::fscanf(file, "%ld %ld", &size, &resident);
+    std::fclose(file);
+    if (fields != 2) {
+        return 0.0;
+    }
+    return static_cast<double>(resident) * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+} // namespace
+
+int main() {
+    const int counts[] = {1, 10, 100, 1000, 10000};
+    const int trackPoints = 5000;
+    const int maxPrivate = 200;   // private copies beyond this exhaust memory
+
+    std::vector<TrackPoint> points = makeTrack(trackPoints);
+    RobotConfig config = makeConfig();
+    double baseline = residentMiB();
+
+    std::printf("track: %d points, baseline RSS %.1f MiB\n", trackPoints, baseline);
+    std::printf("%10s %16s %16s\n", "simulators", "shared MiB", "private MiB");
+
+    for (int count : counts) {
+        double shared;
+        {
+            auto track = std::make_shared<const CompiledTrack>(points);
+            std::vector<std::unique_ptr<Simulator>> simulators;
+            for (int i = 0; i < count; i++) {
+                simulators.push_back(std::make_unique<Simulator>(config, track));
+                simulators.back()->initialize();
+                simulators.back()->step(0.001f);
+            }
+            shared = residentMiB() - baseline;
+        }
+        if (count > maxPrivate) {
+            std::printf("%10d %16.1f %16s\n", count, shared, "-");
+            continue;
+        }
+        double separate;
+        {
+            std::vector<std::unique_ptr<Simulator>> simulators;
+            for (int i = 0; i < count; i++) {
+                simulators.push_back(std::make_unique<Simulator>(config, points));
+                simulators.back()->initialize();
+                simulators.back()->step(0.001f);
+            }
+            separate = residentMiB() - baseline;
+        }
+        std::printf("%10d %16.1f %16.1f\n", count, shared, separate);
+    }
+
+    return 0;
+}
@@ -12,9 +12,14 @@
 
 #include "../simulator.hpp"
 #include "../pattern_recognizer.hpp"
+#include <limits>
+#include <string>
 #include <vector>
 
 namespace LineFollower {
+
+class ThreadPool;
+
 namespace Artifacts {
 
 /**
@@ -39,7 +44,8 @@ public:
      * @param artifact Artifact description
      */
     explicit ArtifactBase(const Artifact& artifact)
-        : artifact_(artifact) {}
+        : artifact_(artifact)
+        , exitLimit_(std::numeric_limits<float>::max()) {}
 
     /**
      * @brief Virtual destructor
@@ -69,8 +75,40 @@ public:
      */
     ArtifactType getType() const { return artifact_.type; }
 
+    /**
+     * @brief Cap the exit speed, typically the next artifact's entry limit
+     * @param speed Highest speed allowed at the exit (m/s)
+     */
+    void setExitLimit(float speed) { exitLimit_ = speed; }
+
+    /**
+     * @brief Racing lines for many artifacts, solved in parallel
+     *
+     * Artifacts are independent QPs (ends pinned to the line), so each one
+     * is a separate pool task.
+     *
+     * @param artifacts Artifacts to solve
+     * @param trackPoints Full track points
+     * @param halfWidth Allowed lateral offset either side of the line (m)
+     * @param pool Thread pool running the solves
+     * @return One offset polyline per artifact, in the same order
+     */
+    static std::vector<std::vector<TrackPoint>> calculateRacingLines(
+        const std::vector<Artifact>& artifacts,
+        const std::vector<TrackPoint>& trackPoints,
+        float halfWidth,
+        ThreadPool& pool
+    );
+
+    /**
+     * @brief Lateral corridor a robot can use while keeping the line under
+     *        its sensor array (m)
+     */
+    static float corridorHalfWidth(const RobotConfig& config);
+
 protected:
     Artifact artifact_;
+    float exitLimit_;        // speed cap at the exit (m/s)
 
     /**
      * @brief Helper: Calculate maximum safe speed based on physics
@@ -80,13 +118,63 @@ protected:
         const RobotConfig& config
     ) const;
 
+    /**
+     * @brief Helper: Accelerate, cruise, brake over a length
+     *
+     * Closed-form trapezoid with the configuration's acceleration and
+     * braking limits. The entry speed is lowered if the exit cap could not
+     * otherwise be met, so with prevExitSpeed unbounded the result's
+     * entrySpeed is the fastest admissible entry.
+     *
+     * @param length Distance (m)
+     * @param entrySpeed Speed arriving from the previous artifact (m/s)
+     * @param cruiseSpeed Highest speed inside the artifact (m/s)
+     * @param exitSpeed Highest speed at the exit (m/s)
+     * @param config Robot configuration
+     * @param strategy Speeds and time filled in
+     */
+    void traverse(
+        float length,
+        float entrySpeed,
+        float cruiseSpeed,
+        float exitSpeed,
+        const RobotConfig& config,
+        ArtifactStrategy& strategy
+    ) const;
+
+    /**
+     * @brief Helper: Radius of the outside-apex-outside arc through a curve
+     * @param radius Centreline radius (m)
+     * @param turnAngle Heading change (rad)
+     * @param halfWidth Corridor half-width (m)
+     */
+    static float effectiveRadius(float radius, float turnAngle, float halfWidth);
+
     /**
      * @brief Helper: Calculate optimal racing line
+     *
+     * Minimum-curvature line as a sparse QP over lateral offsets along the
+     * line normals: minimize the summed squared discrete curvature subject
+     * to |offset| <= halfWidth, with both ends pinned to the line so
+     * neighbouring artifacts join up, plus a light pull back toward the
+     * line. The QP lives on a uniform arc-length grid (2 cm, or the point
+     * spacing if coarser) resampled from the points, so dense tracks do
+     * not drown the curvature in coordinate noise; the offsets are
+     * interpolated back to every point. Solved by an interior point method
+     * whose Newton steps are banded sparse LDLT factorizations, so cost is
+     * linear in the span length.
+     *
+     * @param trackPoints Full track points
+     * @param startIndex First point of the span
+     * @param endIndex Last point of the span
+     * @param halfWidth Allowed lateral offset either side of the line (m)
+     * @return Offset polyline, one point per track point in the span
      */
     std::vector<TrackPoint> calculateRacingLine(
         const std::vector<TrackPoint>& trackPoints,
         int startIndex,
-        int endIndex
+        int endIndex,
+        float halfWidth
     ) const;
 };
 
@@ -0,0 +1,54 @@
+/**
+ * @file artifact_factory.hpp
+ * @brief Map recognized artifacts to their strategies and estimate a lap
+ *
+ * A backward pass propagates each artifact's admissible entry speed into
+ * its predecessor's exit cap, then a forward pass from standstill sums the
+ * traversal times. Closed-form strategies cost a microsecond or two each;
+ * a complex artifact runs direct collocation, milliseconds per solve, and
+ * dominates the estimate whenever the track has one.
+ */
+
+#ifndef ARTIFACT_FACTORY_HPP
+#define ARTIFACT_FACTORY_HPP
+
+#include "artifact_base.hpp"
+#include <memory>
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Track-level estimate
+ */
+struct TrackEstimate {
+    std::vector<ArtifactStrategy> strategies;   // one per artifact, in order
+    float totalTime;                            // s
+};
+
+/**
+ * @brief Strategy object for an artifact
+ *
+ * Transitions map to circular curves (their straights are separate
+ * artifacts); unknown and complex geometry to Complex, which solves its
+ * speed profile by direct collocation.
+ */
+std::unique_ptr<ArtifactBase> createArtifact(const Artifact& artifact);
+
+/**
+ * @brief Lap time estimate from analytical strategies, no simulation
+ * @param artifacts Artifacts from PatternRecognizer, in track order
+ * @param config Robot configuration
+ * @param trackPoints Full track points
+ * @return Strategy per artifact and total time
+ */
+TrackEstimate estimateTrack(
+    const std::vector<Artifact>& artifacts,
+    const RobotConfig& config,
+    const std::vector<TrackPoint>& trackPoints
+);
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // ARTIFACT_FACTORY_HPP
@@ -0,0 +1,31 @@
+/**
+ * @file chicane.hpp
+ * @brief Chicane: alternating short curves, straight-lined when the corridor allows
+ */
+
+#ifndef CHICANE_HPP
+#define CHICANE_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Chicane strategy
+ */
+class Chicane : public ArtifactBase {
+public:
+    explicit Chicane(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // CHICANE_HPP
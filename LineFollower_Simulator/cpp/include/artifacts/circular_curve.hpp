@@ -0,0 +1,31 @@
+/**
+ * @file circular_curve.hpp
+ * @brief Constant-radius curve: grip-limited speed on the widest racing line
+ */
+
+#ifndef CIRCULAR_CURVE_HPP
+#define CIRCULAR_CURVE_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Constant-radius curve strategy
+ */
+class CircularCurve : public ArtifactBase {
+public:
+    explicit CircularCurve(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // CIRCULAR_CURVE_HPP
@@ -0,0 +1,51 @@
+/**
+ * @file complex.hpp
+ * @brief Unrecognized geometry: minimum-time speed by direct collocation
+ */
+
+#ifndef COMPLEX_HPP
+#define COMPLEX_HPP
+
+#include "artifact_base.hpp"
+#include "../optimizers/direct_collocation.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Unrecognized geometry strategy
+ *
+ * The only artifact that pays for numerical optimization. The solution is
+ * kept between calls: estimateTrack's forward pass reuses the backward
+ * pass's solve whenever its entry cap does not bind.
+ */
+class Complex : public ArtifactBase {
+public:
+    explicit Complex(const Artifact& artifact)
+        : ArtifactBase(artifact), spacing_(0.0f), solved_(false), solvedEntry_(0.0f), solvedExit_(0.0f), solvedConfig_() {}
+
+    /**
+     * @brief Solve the segment numerically; falls back to a constant
+     *        speed at the tightest curvature if the solver cannot
+     */
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+
+private:
+    std::vector<float> curvature_;   // compiled once, reused across passes
+    float spacing_;
+
+    Optimizers::CollocationResult solution_;   // last solve, its caps and robot
+    bool solved_;
+    float solvedEntry_;
+    float solvedExit_;
+    RobotConfig solvedConfig_;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // COMPLEX_HPP
@@ -0,0 +1,31 @@
+/**
+ * @file hairpin.hpp
+ * @brief Hairpin: tight turn at low apex speed with a wide, late line
+ */
+
+#ifndef HAIRPIN_HPP
+#define HAIRPIN_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Hairpin strategy
+ */
+class Hairpin : public ArtifactBase {
+public:
+    explicit Hairpin(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // HAIRPIN_HPP
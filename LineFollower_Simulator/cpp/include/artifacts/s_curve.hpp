@@ -0,0 +1,31 @@
+/**
+ * @file s_curve.hpp
+ * @brief S-curve: two opposite lobes taken at one grip-limited speed
+ */
+
+#ifndef S_CURVE_HPP
+#define S_CURVE_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief S-curve strategy
+ */
+class SCurve : public ArtifactBase {
+public:
+    explicit SCurve(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // S_CURVE_HPP
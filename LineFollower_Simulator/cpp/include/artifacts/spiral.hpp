@@ -0,0 +1,31 @@
+/**
+ * @file spiral.hpp
+ * @brief Spiral: speed follows the grip limit of the changing curvature
+ */
+
+#ifndef SPIRAL_HPP
+#define SPIRAL_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Spiral strategy
+ */
+class Spiral : public ArtifactBase {
+public:
+    explicit Spiral(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // SPIRAL_HPP
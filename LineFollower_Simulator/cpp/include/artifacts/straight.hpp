@@ -0,0 +1,31 @@
+/**
+ * @file straight.hpp
+ * @brief Straight segment: full throttle, brake as late as the exit allows
+ */
+
+#ifndef STRAIGHT_HPP
+#define STRAIGHT_HPP
+
+#include "artifact_base.hpp"
+
+namespace LineFollower {
+namespace Artifacts {
+
+/**
+ * @brief Straight segment strategy
+ */
+class Straight : public ArtifactBase {
+public:
+    explicit Straight(const Artifact& artifact) : ArtifactBase(artifact) {}
+
+    ArtifactStrategy calculateOptimalStrategy(
+        const RobotConfig& robotConfig,
+        const std::vector<TrackPoint>& trackPoints,
+        float prevExitSpeed
+    ) override;
+};
+
+} // namespace Artifacts
+} // namespace LineFollower
+
+#endif // STRAIGHT_HPP
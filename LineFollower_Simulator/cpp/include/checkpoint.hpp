@@ -0,0 +1,158 @@
+/**
+ * @file checkpoint.hpp
+ * @brief Binary checkpoint buffers for long optimization runs
+ *
+ * A checkpoint is a flat little-endian byte buffer: a magic tag and format
+ * version, whatever the writer appended in order, and a 64-bit checksum.
+ * Readers reject a buffer whose header or checksum does not match (a
+ * truncated file, an older format), then consume the same sequence and
+ * latch a failure flag on the first short or malformed read, so callers
+ * check once at the end. Plain structs are copied bytewise, which is
+ * portable between the native and WebAssembly builds as long as they hold
+ * only fixed-size fields (no long, no pointers).
+ */
+
+#ifndef CHECKPOINT_HPP
+#define CHECKPOINT_HPP
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace LineFollower {
+
+/**
+ * @brief Appends values to a checkpoint buffer
+ */
+class CheckpointWriter {
+public:
+    /**
+     * @brief Constructor - writes the header
+     */
+    CheckpointWriter();
+
+    /**
+     * @brief Append a plain value
+     */
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be plain data");
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+
+    /**
+     * @brief Append a vector of plain values, length first
+     */
+    template <typename T>
+    void write(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be plain data");
+        write(static_cast<uint32_t>(values.size()));
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values.data());
+        buffer_.insert(buffer_.end(), bytes, bytes + values.size() * sizeof(T));
+    }
+
+    void write(const std::string& text);
+    void write(const Eigen::MatrixXd& matrix);
+    void write(const Eigen::VectorXd& vector);
+    void write(const std::mt19937& rng);
+
+    /**
+     * @brief Append the checksum and hand over the finished checkpoint
+     *
+     * The writer is empty afterwards.
+     */
+    std::vector<uint8_t> finish();
+
+    /**
+     * @brief Write a finished checkpoint to a file, replacing it atomically
+     * @param path Destination path
+     * @param checkpoint Bytes from finish()
+     * @return true on success
+     */
+    static bool save(const std::string& path, const std::vector<uint8_t>& checkpoint);
+
+private:
+    std::vector<uint8_t> buffer_;
+};
+
+/**
+ * @brief Reads values back in the order they were written
+ */
+class CheckpointReader {
+public:
+    /**
+     * @brief Constructor - checks the header and checksum
+     * @param buffer Finished checkpoint bytes (must outlive the reader)
+     */
+    explicit CheckpointReader(const std::vector<uint8_t>& buffer);
+
+    /**
+     * @brief Read a plain value
+     * @return false once any read has failed
+     */
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable<T>::value, "checkpoint values must be plain data");
+        if (!take(sizeof(T))) {
+            return false;
+        }
+        std::memcpy(&value, buffer_.data() + offset_ - sizeof(T), sizeof(T));
+        return true;
+    }
+
+    /**
+     * @brief Read a vector of plain values
+     */
+    template <typename T>
+    bool read(std::vector<T>& values) {
+        uint32_t count = 0;
+        if (!read(count) || count > (limit_ - offset_) / sizeof(T)) {
+            ok_ = false;
+            return false;
+        }
+        values.resize(count);
+        if (!take(count * sizeof(T))) {
+            return false;
+        }
+        std::memcpy(values.data(), buffer_.data() + offset_ - count * sizeof(T), count * sizeof(T));
+        return true;
+    }
+
+    bool read(std::string& text);
+    bool read(Eigen::MatrixXd& matrix);
+    bool read(Eigen::VectorXd& vector);
+    bool read(std::mt19937& rng);
+
+    /**
+     * @brief Header valid and every read so far succeeded
+     */
+    bool ok() const { return ok_; }
+
+    /**
+     * @brief Read a whole file into a buffer
+     * @param path Source path
+     * @param buffer Output bytes
+     * @return true on success
+     */
+    static bool load(const std::string& path, std::vector<uint8_t>& buffer);
+
+private:
+    const std::vector<uint8_t>& buffer_;
+    size_t offset_;
+    size_t limit_;           // end of the payload, before the checksum
+    bool ok_;
+
+    /**
+     * @brief Consume bytes, failing if fewer remain
+     */
+    bool take(size_t bytes);
+};
+
+} // namespace LineFollower
+
+#endif // CHECKPOINT_HPP
@@ -0,0 +1,137 @@
+/**
+ * @file compiled_track.hpp
+ * @brief Immutable, arc-length parameterized form of a track
+ *
+ * Built once from the editor's polyline. Resamples the line at uniform arc
+ * length and caches position, heading and curvature in contiguous arrays,
+ * alongside the segment index used for sensor queries. Progress tracking,
+ * lap completion and curvature look-ahead become O(1) lookups.
+ */
+
+#ifndef COMPILED_TRACK_HPP
+#define COMPILED_TRACK_HPP
+
+#include <vector>
+#include <cstdint>
+#include "simulator.hpp"
+#include "track_index.hpp"
+
+namespace LineFollower {
+
+/**
+ * @brief Compiled track geometry
+ */
+class CompiledTrack {
+public:
+    /**
+     * @brief Default resampling spacing (m)
+     */
+    static constexpr float DEFAULT_SPACING = 0.01f;
+
+    /**
+     * @brief Compile a track
+     * @param trackPoints Track polyline (meters)
+     * @param spacing Resampling spacing along the line (m)
+     */
+    explicit CompiledTrack(const std::vector<TrackPoint>& trackPoints, float spacing = DEFAULT_SPACING);
+
+    /**
+     * @brief Number of resampled points
+     */
+    int size() const { return static_cast<int>(s_.size()); }
+
+    /**
+     * @brief Actual sample spacing (m), total length divided evenly
+     */
+    float spacing() const { return spacing_; }
+
+    /**
+     * @brief Total track length (m)
+     */
+    float length() const { return index_.totalLength(); }
+
+    /**
+     * @brief Whether the track ends where it starts
+     */
+    bool isClosed() const { return closed_; }
+
+    /**
+     * @brief Resampled arrays, indexed by sample
+     */
+    const std::vector<float>& arcLength() const { return s_; }
+    const std::vector<float>& x() const { return x_; }
+    const std::vector<float>& y() const { return y_; }
+    const std::vector<float>& heading() const { return heading_; }
+    const std::vector<float>& curvature() const { return curvature_; }  // signed, positive turning left
+
+    /**
+     * @brief Sample nearest to an arc length
+     */
+    int sampleAt(float arcLength) const;
+
+    /**
+     * @brief Curvature at an arc length (linear interpolation)
+     */
+    float curvatureAt(float arcLength) const;
+
+    /**
+     * @brief Largest absolute curvature over an arc-length range, in O(1)
+     */
+    float maxCurvature(float from, float to) const;
+
+    /**
+     * @brief Original polyline
+     */
+    const std::vector<TrackPoint>& points() const { return index_.points(); }
+
+    /**
+     * @brief Arc length at an original track point
+     */
+    float pointArcLength(int pointIndex) const { return index_.pointArcLength(pointIndex); }
+
+    /**
+     * @brief Length between two original track points, in O(1)
+     */
+    float lengthBetween(int startPoint, int endPoint) const {
+        return pointArcLength(endPoint) - pointArcLength(startPoint);
+    }
+
+    /**
+     * @brief Original segment containing an arc length, in O(log N)
+     */
+    int segmentAt(float arcLength) const;
+
+    /**
+     * @brief Spatial index over the original segments
+     */
+    const TrackIndex& index() const { return index_; }
+
+    /**
+     * @brief Hash of the original geometry (equal points, equal hash)
+     */
+    uint64_t hash() const { return hash_; }
+
+private:
+    TrackIndex index_;
+    float spacing_;
+    bool closed_;
+    uint64_t hash_;
+
+    std::vector<float> s_;
+    std::vector<float> x_;
+    std::vector<float> y_;
+    std::vector<float> heading_;
+    std::vector<float> curvature_;
+
+    // Sparse table for range maximum of |curvature|: level k holds the
+    // maximum over 2^k samples starting at each index
+    std::vector<std::vector<float>> curvatureMax_;
+
+    void resample(float spacing);
+    void computeCurvature();
+    void buildCurvatureTable();
+};
+
+} // namespace LineFollower
+
+#endif // COMPILED_TRACK_HPP
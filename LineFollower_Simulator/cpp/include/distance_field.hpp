@@ -0,0 +1,113 @@
+/**
+ * @file distance_field.hpp
+ * @brief Tiled, lazily built distance field of the track line
+ *
+ * Rasterizes the distance to the track line once per tile at a fixed
+ * resolution so a sensor reading becomes a bilinear fetch. Tiles are built
+ * on first access, tiles far from the line are stored as empty, and resident
+ * tiles are recycled least-recently-used once the memory limit is reached.
+ */
+
+#ifndef DISTANCE_FIELD_HPP
+#define DISTANCE_FIELD_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace LineFollower {
+
+class TrackIndex;
+
+/**
+ * @brief Lazily rasterized distance-to-line field
+ *
+ * Samples store the distance signed by which side of the nearest segment the
+ * point lies on, so interpolation across the line stays sharp. Not thread
+ * safe: each simulator owns its own field.
+ */
+class DistanceField {
+public:
+    /**
+     * @brief Constructor
+     * @param index Track index used to build tiles (must outlive the field)
+     * @param resolution Sample spacing (m)
+     * @param maxDistance Distances are clamped to this value (m)
+     * @param memoryLimit Maximum bytes of resident tile data (0 = unlimited)
+     */
+    DistanceField(const TrackIndex& index, float resolution, float maxDistance, size_t memoryLimit);
+
+    /**
+     * @brief Distance from a point to the track line
+     * @return Interpolated distance, or maxDistance outside the field
+     */
+    float sample(float x, float y);
+
+    /**
+     * @brief Bytes of tile data currently resident
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Number of tiles built since construction (including rebuilds)
+     */
+    int tilesBuilt() const { return tilesBuilt_; }
+
+    /**
+     * @brief Sample spacing (m)
+     */
+    float resolution() const { return resolution_; }
+
+private:
+    static constexpr int TILE_SIZE = 32;                 // cells per tile side
+    static constexpr int TILE_SAMPLES = TILE_SIZE + 1;   // samples per side (shared border)
+    static constexpr int TILE_UNBUILT = -1;
+    static constexpr int TILE_EMPTY = -2;
+
+    struct Tile {
+        std::vector<float> samples;  // TILE_SAMPLES x TILE_SAMPLES, row-major
+        int tileIndex;               // owner in tileSlot_
+        uint32_t lastUse;
+    };
+
+    const TrackIndex& index_;
+    float resolution_;
+    float invResolution_;
+    float maxDistance_;
+
+    // Field extent
+    float originX_, originY_;
+    int tilesX_, tilesY_;
+
+    // Slot of each tile in tiles_, or TILE_UNBUILT / TILE_EMPTY
+    std::vector<int> tileSlot_;
+    std::vector<Tile> tiles_;
+    size_t maxResident_;
+    uint32_t useCounter_;
+    int tilesBuilt_;
+
+    /**
+     * @brief Get samples for a tile, building or recycling as needed
+     * @return Sample pointer, or nullptr for an empty tile
+     */
+    const float* acquireTile(int tx, int ty);
+
+    /**
+     * @brief Check whether any sample of a tile is within maxDistance
+     */
+    bool tileNearLine(int tx, int ty) const;
+
+    /**
+     * @brief Rasterize a tile into a sample buffer
+     */
+    void buildTile(int tx, int ty, std::vector<float>& samples) const;
+
+    /**
+     * @brief Signed distance at a point
+     */
+    float signedDistance(float x, float y) const;
+};
+
+} // namespace LineFollower
+
+#endif // DISTANCE_FIELD_HPP
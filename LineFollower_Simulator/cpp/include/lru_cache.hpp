@@ -0,0 +1,133 @@
+/**
+ * @file lru_cache.hpp
+ * @brief Fixed-capacity least-recently-used cache keyed by 64-bit hashes
+ *
+ * Used to memoize simulation results: keys are hashes of everything that
+ * determines a run, so a hit returns the stored value without simulating.
+ * Not thread-safe; callers look up and insert from one thread.
+ */
+
+#ifndef LRU_CACHE_HPP
+#define LRU_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace LineFollower {
+
+/**
+ * @brief LRU cache
+ * @tparam Value Stored value type
+ */
+template <typename Value>
+class LRUCache {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Maximum entries (0 disables caching)
+     */
+    explicit LRUCache(size_t capacity = 0)
+        : capacity_(capacity)
+        , hits_(0)
+        , misses_(0)
+    {
+    }
+
+    /**
+     * @brief Look up a key, marking it most recently used
+     * @param key Entry key
+     * @param value Output value on a hit
+     * @return true on a hit
+     */
+    bool find(uint64_t key, Value& value) {
+        auto it = map_.find(key);
+        if (it == map_.end()) {
+            misses_++;
+            return false;
+        }
+        entries_.splice(entries_.begin(), entries_, it->second);
+        value = it->second->second;
+        hits_++;
+        return true;
+    }
+
+    /**
+     * @brief Insert or replace an entry, evicting the least recently used
+     * @param key Entry key
+     * @param value Value to store
+     */
+    void insert(uint64_t key, const Value& value) {
+        if (capacity_ == 0) {
+            return;
+        }
+        auto it = map_.find(key);
+        if (it != map_.end()) {
+            it->second->second = value;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+        if (map_.size() >= capacity_) {
+            map_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, value);
+        map_[key] = entries_.begin();
+    }
+
+    /**
+     * @brief Change the capacity, evicting entries beyond it
+     */
+    void setCapacity(size_t capacity) {
+        capacity_ = capacity;
+        while (map_.size() > capacity_) {
+            map_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+    }
+
+    /**
+     * @brief Remove every entry and reset the counters
+     */
+    void clear() {
+        entries_.clear();
+        map_.clear();
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+    /**
+     * @brief Visit every entry from least to most recently used
+     *
+     * Inserting the entries in this order into an empty cache restores
+     * the recency order.
+     *
+     * @param visit Called with each key and value
+     */
+    template <typename Visitor>
+    void forEach(Visitor visit) const {
+        for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+            visit(it->first, it->second);
+        }
+    }
+
+    size_t size() const { return map_.size(); }
+    size_t capacity() const { return capacity_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    using Entry = std::pair<uint64_t, Value>;
+
+    size_t capacity_;
+    std::list<Entry> entries_;      // most recently used first
+    std::unordered_map<uint64_t, typename std::list<Entry>::iterator> map_;
+    uint64_t hits_;
+    uint64_t misses_;
+};
+
+} // namespace LineFollower
+
+#endif // LRU_CACHE_HPP
@@ -15,20 +15,107 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <string>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include "simulator.hpp"
+#include "lru_cache.hpp"
 
 namespace LineFollower {
 
+class ThreadPool;
+class CheckpointWriter;
+class CheckpointReader;
+
+/**
+ * @brief Search algorithm used by Optimizer::optimize
+ */
+enum class SearchStrategy {
+    GRADIENT_DESCENT,     // finite-difference gradient with parallel line search
+    CMA_ES,               // covariance matrix adaptation evolution strategy
+    LBFGS,                // quasi-Newton on finite-difference gradients (smooth cases)
+    HYPERBAND,            // successive halving from lap prefixes up to full laps
+    NSGA2                 // multi-objective: Pareto front of lap time, energy and tracking error
+};
+
+/**
+ * @brief CMA-ES restart policy
+ */
+enum class RestartPolicy {
+    NONE,                 // single run
+    IPOP,                 // restart with doubled population each time
+    BIPOP                 // alternate doubled populations with small local runs
+};
+
+/**
+ * @brief Risk measure a robust search scores each candidate by
+ *
+ * Every measure takes the mean fitness of a tail of the scenarios, worst
+ * first, with failed laps ranked worst and scoring 0. A failure in any
+ * scenario therefore zeroes WORST_CASE, while MEAN and CVAR lose that
+ * scenario's share of the averaged tail.
+ */
+enum class RobustObjective {
+    WORST_CASE,           // the single worst scenario
+    MEAN,                 // every scenario
+    CVAR                  // the worst cvarAlpha share of scenarios
+};
+
+/**
+ * @brief Gain rule applied to a relay autotuning experiment
+ */
+enum class TuningRule {
+    ZIEGLER_NICHOLS,      // classic ultimate-gain rule, fast and lightly damped
+    TYREUS_LUYBEN,        // detuned ultimate-gain rule, less overshoot
+    COHEN_COON            // first-order-plus-dead-time model fitted to the cycle
+};
+
+/**
+ * @brief How much simulation one fitness evaluation spends
+ *
+ * Cheap fidelities score a prefix of the lap with a coarser control
+ * period; the default value is the full lap at the standard period.
+ */
+struct Fidelity {
+    float arcLength;         // stop once this much track is covered (m); 0 = full lap
+    float dt;                // control period (s); 0 = standard 1 ms
+};
+
 /**
  * @brief Optimization parameters
  */
 struct OptimizationParams {
     int maxIterations;       // Maximum optimization iterations
     float tolerance;         // Convergence tolerance
-    float learningRate;      // For gradient-based methods
+    float learningRate;      // First line-search step as a share of each parameter, clamped to (0, 1]
     bool useAnalytical;      // Use analytical solutions when possible
     bool useNumerical;       // Use numerical optimization for complex sections
-    int populationSize;      // For stochastic methods (if used)
+    int populationSize;      // Candidates evaluated in parallel per iteration
+    float sensorNoise;       // Sensor noise std dev during evaluation (0 = deterministic)
+    bool tuneSpeed;          // Also tune maxSpeed alongside the PID gains
+    SearchStrategy strategy; // Algorithm used by optimize()
+    float sigma;             // CMA-ES initial step, as a fraction of each parameter
+    RestartPolicy restartPolicy; // CMA-ES restarts once a run stagnates
+    int maxRestarts;         // CMA-ES restarts after the first run
+    int cacheSize;           // Simulation results kept across optimize() calls (0 disables)
+    float timeBudget;        // Wall-clock seconds per optimize() call (0 = unlimited)
+    float checkpointInterval; // Wall-clock seconds between checkpoints (0 disables)
+    int scenarioCount;       // Robust mode: environments per candidate (0 or 1 = nominal only)
+    float frictionSpread;    // Robust mode: friction varies by up to this fraction either way
+    float temperatureSpread; // Robust mode: temperature varies by up to this many degrees C either way
+    RobustObjective robustObjective; // Robust mode: risk measure optimized
+    float cvarAlpha;         // Robust mode: tail share averaged by CVAR (0-1]
+};
+
+/**
+ * @brief One configuration on the lap time / energy / tracking error front
+ */
+struct ParetoPoint {
+    RobotConfig config;
+    float completionTime;    // s
+    float energyConsumption; // J
+    float trackErrors;       // mean absolute line error (m)
 };
 
 /**
@@ -42,6 +129,14 @@ struct OptimizationResult {
     int iterations;
     bool converged;
     std::string strategy;    // Description of strategy applied
+    float lapTimeBound;      // minimum-time profile lap for optimalConfig (s)
+    long evaluations;        // simulations run so far (cache hits excluded)
+    float elapsedTime;       // wall-clock seconds spent, across resumed sessions
+    std::vector<ParetoPoint> paretoFront;   // NSGA2 only, fastest first; empty otherwise
+    float worstCaseFitness;  // optimalConfig under each risk measure in robust
+    float meanFitness;       // mode; all equal to fitnessScore otherwise or
+                             // when the search was stopped
+    float cvarFitness;
 };
 
 /**
@@ -60,87 +155,492 @@ public:
      */
     ~Optimizer();
 
+    /**
+     * @brief Called with each new best full-lap result while optimizing
+     *
+     * Runs on the thread that called optimize(); strategy is empty.
+     */
+    using BestCallback = std::function<void(const OptimizationResult&)>;
+
+    /**
+     * @brief Called with the bytes of each checkpoint as it is taken
+     */
+    using CheckpointCallback = std::function<void(const std::vector<uint8_t>&)>;
+
     /**
      * @brief Optimize robot configuration for given track
+     *
+     * Anytime: on cancel() or once timeBudget runs out, in-flight
+     * simulations stop, the search unwinds and the best full lap found so
+     * far is returned with converged = false.
+     *
      * @param initialConfig Starting configuration
      * @param trackPoints Track definition
      * @param progressCallback Optional callback for progress updates (0-100)
+     * @param bestCallback Optional callback streaming every improvement
      * @return Optimization result
      */
     OptimizationResult optimize(
         const RobotConfig& initialConfig,
         const std::vector<TrackPoint>& trackPoints,
-        std::function<void(float)> progressCallback = nullptr
+        std::function<void(float)> progressCallback = nullptr,
+        BestCallback bestCallback = nullptr
+    );
+
+    /**
+     * @brief Continue a run from a checkpoint file
+     *
+     * Restores the search state, track, cache and best-so-far saved by an
+     * earlier optimize() or resume() and carries on as if never stopped.
+     * The time budget and checkpoint settings of this optimizer apply,
+     * not the saved ones. L-BFGS restarts from its best point with fresh
+     * curvature pairs; the other strategies continue exactly.
+     *
+     * @param path Checkpoint file
+     * @param result Output result of the continued run
+     * @param progressCallback Optional callback for progress updates (0-100)
+     * @param bestCallback Optional callback streaming every improvement
+     * @return false if the file is missing, truncated or from another
+     *         format; the optimizer then keeps its own settings and state
+     */
+    bool resume(
+        const std::string& path,
+        OptimizationResult& result,
+        std::function<void(float)> progressCallback = nullptr,
+        BestCallback bestCallback = nullptr
+    );
+
+    /**
+     * @brief Continue a run from checkpoint bytes (see resume)
+     */
+    bool resumeFromBuffer(
+        const std::vector<uint8_t>& checkpoint,
+        OptimizationResult& result,
+        std::function<void(float)> progressCallback = nullptr,
+        BestCallback bestCallback = nullptr
     );
 
     /**
-     * @brief Optimize only PID gains (faster than full optimization)
+     * @brief Where checkpoints go besides getCheckpoint()
+     *
+     * Checkpoints are taken every checkpointInterval seconds between
+     * generations (iterations, rungs) and once more when a run is stopped
+     * by cancel() or its time budget.
+     *
+     * @param path File replaced atomically at every checkpoint (empty = none)
+     * @param callback Optional hook receiving each checkpoint's bytes
+     */
+    void setCheckpointTarget(const std::string& path, CheckpointCallback callback = nullptr);
+
+    /**
+     * @brief Change the checkpoint interval of later runs
+     * @param seconds Interval in seconds (0 disables)
+     */
+    void setCheckpointInterval(float seconds) { params_.checkpointInterval = seconds; }
+
+    /**
+     * @brief Most recent checkpoint (empty before the first)
+     */
+    const std::vector<uint8_t>& getCheckpoint() const { return checkpoint_; }
+
+    /**
+     * @brief Tune the PID gains by relay feedback (Astrom-Hagglund)
+     *
+     * One simulation: a relay replaces the controller on a straight that
+     * runs into a curve as tight as the track's tightest, driving the line
+     * error into a limit cycle. Its amplitude and period give the ultimate
+     * gain and period, and the rule turns those into gains. Takes
+     * milliseconds; the result is a quick tune or a seed for optimize().
+     *
      * @param config Robot configuration with fixed physical parameters
      * @param trackPoints Track definition
-     * @return Optimized configuration
+     * @param rule Gain rule
+     * @return Configuration with tuned gains; unchanged if no limit cycle formed
      */
     RobotConfig optimizePID(
         const RobotConfig& config,
-        const std::vector<TrackPoint>& trackPoints
+        const std::vector<TrackPoint>& trackPoints,
+        TuningRule rule = TuningRule::ZIEGLER_NICHOLS
     );
 
     /**
      * @brief Cancel ongoing optimization
+     *
+     * Safe to call from any thread; optimize() returns its best so far.
      */
     void cancel();
 
+    /**
+     * @brief Change the wall-clock budget of later optimize() calls
+     * @param seconds Budget in seconds (0 = unlimited)
+     */
+    void setTimeBudget(float seconds) { params_.timeBudget = seconds; }
+
+    /**
+     * @brief Score candidates across sampled environments in later runs
+     *
+     * Each candidate runs in scenarioCount environments whose friction and
+     * temperature form a Latin hypercube around the candidate's own
+     * values. Every candidate of a search sees the same scenarios, so
+     * candidates are compared under common conditions. Gravity is left
+     * alone.
+     *
+     * @param scenarioCount Environments per candidate (0 or 1 = nominal only)
+     * @param frictionSpread Largest relative friction change either way
+     * @param temperatureSpread Largest temperature change either way (degrees C)
+     * @param objective Risk measure optimized
+     * @param cvarAlpha Tail share averaged by CVAR
+     */
+    void setRobust(int scenarioCount, float frictionSpread, float temperatureSpread,
+                   RobustObjective objective, float cvarAlpha);
+
+    /**
+     * @brief Change the search algorithm of later optimize() calls
+     */
+    void setStrategy(SearchStrategy strategy) { params_.strategy = strategy; }
+
+    /**
+     * @brief Evaluations answered from the result cache
+     */
+    uint64_t getCacheHits() const { return cache_.hits(); }
+
+    /**
+     * @brief Evaluations that had to be simulated
+     */
+    uint64_t getCacheMisses() const { return cache_.misses(); }
+
+    /**
+     * @brief Drop every cached result and reset the counters
+     */
+    void clearCache() { cache_.clear(); }
+
 private:
     OptimizationParams params_;
-    bool cancelled_;
+    std::atomic<bool> cancelled_;
+    std::chrono::steady_clock::time_point startTime_;
+    std::chrono::steady_clock::time_point deadline_;   // meaningful when timeBudget > 0
+
+    // Best full lap of the current optimize() call, streamed on improvement
+    OptimizationResult best_;
+    BestCallback bestCallback_;
+    long evaluations_;
+    float elapsedBefore_;    // seconds spent in the sessions a resume continues
+
+    // Checkpointing
+    std::string checkpointPath_;
+    CheckpointCallback checkpointCallback_;
+    std::vector<uint8_t> checkpoint_;
+    std::chrono::steady_clock::time_point lastCheckpoint_;
+    RobotConfig initialConfig_;                       // search being checkpointed
+    std::shared_ptr<const CompiledTrack> track_;
+    CheckpointReader* resume_;   // strategy state to continue from, taken by the strategy
+    bool resumeFailed_;          // the strategy found its state in resume_ malformed
+    std::unique_ptr<ThreadPool> pool_;   // one worker per hardware thread
+
+    /**
+     * @brief Environment offsets of one robust scenario
+     */
+    struct Scenario {
+        float friction;          // relative change of frictionCoeff
+        float temperature;       // change of temperature (degrees C)
+    };
+    std::vector<Scenario> scenarios_;    // shared by every candidate of a search
+    std::vector<float> gradientSteps_;   // adaptive finite-difference step per parameter
 
     /**
      * @brief Evaluate fitness of a configuration
      * @param config Configuration to evaluate
-     * @param trackPoints Track definition
+     * @param track Compiled track shared by every evaluation
      * @return Fitness score (0-1)
      */
     float evaluateFitness(
         const RobotConfig& config,
-        const std::vector<TrackPoint>& trackPoints
+        const std::shared_ptr<const CompiledTrack>& track
     );
 
     /**
-     * @brief Run single simulation and extract metrics
-     * @param config Configuration
-     * @param trackPoints Track definition
-     * @return Simulation result metrics
+     * @brief Metrics of one simulated run
      */
     struct SimulationMetrics {
-        float completionTime;
+        float completionTime;    // time to finish (the prefix at reduced fidelity)
         float averageSpeed;
         float trackErrors;
         float energyConsumption;
-        bool completed;
+        float progress;          // arc length covered (m)
+        bool completed;          // finished the lap (or the prefix)
+        bool interrupted;        // stopped by cancel() or the deadline; not a result
+        float scenarioFitness = -1.0f;   // risk measure over robust scenarios; -1 for one run
     };
 
-    SimulationMetrics runSimulation(
+    // Results keyed by quantized configuration, track and noise settings
+    LRUCache<SimulationMetrics> cache_;
+
+    /**
+     * @brief Run many configurations in lockstep in one SimulatorBatch
+     *
+     * Once a stop is requested the runs still going come back interrupted.
+     *
+     * @param configs Configurations
+     * @param track Compiled track
+     * @param cutoffTime Abort runs that cannot finish before this time (0 = no cutoff)
+     * @param noiseSeed Sensor noise seed shared by every configuration
+     * @param fidelity Lap prefix and control period to simulate
+     * @return Metrics for each configuration, in order
+     */
+    std::vector<SimulationMetrics> runSimulation(
+        const std::vector<RobotConfig>& configs,
+        const std::shared_ptr<const CompiledTrack>& track,
+        float cutoffTime,
+        uint32_t noiseSeed,
+        const Fidelity& fidelity
+    );
+
+    /**
+     * @brief Evaluate candidates in parallel on the thread pool
+     *
+     * Every search strategy funnels its simulations through here. In
+     * robust mode each candidate expands into its scenarios, all of them
+     * one batch for simulatePopulation, and comes back as its risk
+     * measure. Full-lap results update the best so far.
+     *
+     * @param configs Candidate configurations
+     * @param track Compiled track shared by every evaluation
+     * @param cutoffTime Abort runs that cannot finish before this time (0 = no cutoff)
+     * @param noiseSeed Sensor noise seed shared by every candidate
+     * @param fidelity Lap prefix and control period to simulate
+     * @return Metrics for each candidate, in order
+     */
+    std::vector<SimulationMetrics> evaluatePopulation(
+        const std::vector<RobotConfig>& configs,
+        const std::shared_ptr<const CompiledTrack>& track,
+        float cutoffTime = 0.0f,
+        uint32_t noiseSeed = 0,
+        const Fidelity& fidelity = Fidelity{0.0f, 0.0f}
+    );
+
+    /**
+     * @brief Simulate configurations in parallel, through the cache
+     *
+     * The runs are split into a few SimulatorBatch chunks per pool thread,
+     * all over the shared compiled track. Configurations already in the cache (or repeated
+     * within the batch) are not simulated again. Once a stop is requested
+     * the remaining ones come back interrupted.
+     *
+     * @param configs Configurations
+     * @param track Compiled track shared by every evaluation
+     * @param cutoffTime Abort runs that cannot finish before this time (0 = no cutoff)
+     * @param noiseSeed Sensor noise seed shared by every configuration
+     * @param fidelity Lap prefix and control period to simulate
+     * @return Metrics for each configuration, in order
+     */
+    std::vector<SimulationMetrics> simulatePopulation(
+        const std::vector<RobotConfig>& configs,
+        const std::shared_ptr<const CompiledTrack>& track,
+        float cutoffTime,
+        uint32_t noiseSeed,
+        const Fidelity& fidelity
+    );
+
+    /**
+     * @brief Latin hypercube of robust scenarios for the current parameters
+     */
+    void sampleScenarios();
+
+    /**
+     * @brief Every configuration under every scenario, configuration-major
+     */
+    std::vector<RobotConfig> scenarioVariants(const std::vector<RobotConfig>& configs) const;
+
+    /**
+     * @brief Average the worst share of scenario runs into one result
+     *
+     * The risk measure is the mean fitness of that share, failed runs
+     * counting as 0, and is carried in scenarioFitness. The other fields
+     * average the same runs and are descriptive only; lap time and speed
+     * average the finished runs alone and stay 0 if none finished.
+     *
+     * @param runs Metrics of one candidate in each scenario
+     * @param share Fraction of the scenarios averaged, worst first (at least one)
+     * @param target Arc length a run had to cover (ranks failed runs)
+     * @return Averaged metrics; completed only if every run was
+     */
+    static SimulationMetrics tailAverage(std::vector<SimulationMetrics> runs, float share, float target);
+
+    /**
+     * @brief Share of the scenarios a risk measure averages
+     */
+    float tailShare(RobustObjective objective) const;
+
+    /**
+     * @brief Run the configured strategy (fresh or resumed) and finish the result
+     * @param initialConfig Configuration the search started from
+     * @param track Compiled track
+     * @param progressCallback Optional progress callback
+     * @param bestCallback Optional best-so-far callback
+     */
+    OptimizationResult search(
+        const RobotConfig& initialConfig,
+        const std::shared_ptr<const CompiledTrack>& track,
+        std::function<void(float)> progressCallback,
+        BestCallback bestCallback
+    );
+
+    /**
+     * @brief Take a checkpoint if the interval has elapsed (or if forced)
+     *
+     * Writes the search-wide state (parameters, track, cache, best so far),
+     * then lets the strategy append its own.
+     *
+     * @param writeState Appends the strategy state
+     * @param force Checkpoint regardless of the interval
+     */
+    void checkpoint(const std::function<void(CheckpointWriter&)>& writeState, bool force);
+
+    /**
+     * @brief Whether the current optimize() call should wind down
+     *
+     * True after cancel() or past the deadline. Read by pool workers too.
+     */
+    bool stopRequested() const;
+
+    /**
+     * @brief Fitness score of a finished run
+     * @param metrics Simulation metrics
+     * @return Fitness score (0-1), 0 if the run did not complete; the
+     *         scenario risk measure for results of tailAverage
+     */
+    static float calculateFitness(const SimulationMetrics& metrics);
+
+    /**
+     * @brief Lap time past which a run cannot beat a fitness score
+     *
+     * Assumes a perfect tracking score, so runs aborted at this time could
+     * not have won. Not applied to MEAN and CVaR scenario averages.
+     *
+     * @param bestFitness Score to beat
+     * @return Cutoff in seconds, or 0 for none
+     */
+    float fitnessCutoff(float bestFitness) const;
+
+    /**
+     * @brief Result fields every strategy reports for its best configuration
+     *
+     * The strategy name is left for the caller to fill in.
+     *
+     * @param config Best configuration
+     * @param fitness Its fitness score
+     * @param metrics Its simulation metrics
+     * @param iterations Iterations the strategy completed
+     * @param converged Whether the strategy met its stopping criterion
+     */
+    static OptimizationResult makeResult(
         const RobotConfig& config,
-        const std::vector<TrackPoint>& trackPoints
+        float fitness,
+        const SimulationMetrics& metrics,
+        int iterations,
+        bool converged
     );
 
     /**
      * @brief Gradient descent optimization
+     *
+     * Each iteration evaluates populationSize step lengths along the
+     * scaled gradient in parallel and keeps the best. The gradient and the
+     * line search of one iteration share a noise seed.
      */
     OptimizationResult gradientDescent(
         const RobotConfig& initialConfig,
-        const std::vector<TrackPoint>& trackPoints,
+        const std::shared_ptr<const CompiledTrack>& track,
+        std::function<void(float)> progressCallback
+    );
+
+    /**
+     * @brief CMA-ES optimization with IPOP/BIPOP restarts
+     *
+     * Searches the PID gains (and maxSpeed with tuneSpeed) in coordinates
+     * relative to the initial configuration. Each generation is one
+     * parallel population sharing a noise seed. maxIterations bounds the
+     * generations of all runs together.
+     */
+    OptimizationResult cmaEs(
+        const RobotConfig& initialConfig,
+        const std::shared_ptr<const CompiledTrack>& track,
+        std::function<void(float)> progressCallback
+    );
+
+    /**
+     * @brief L-BFGS optimization
+     *
+     * Minimizes negative fitness over the same parameters as cmaEs, with
+     * calculateGradient supplying gradients under one fixed noise seed so
+     * the objective is deterministic. Suited to starts that already
+     * complete the lap; from a failing start the gradient is zero.
+     */
+    OptimizationResult lbfgs(
+        const RobotConfig& initialConfig,
+        const std::shared_ptr<const CompiledTrack>& track,
+        std::function<void(float)> progressCallback
+    );
+
+    /**
+     * @brief Hyperband over successive-halving brackets
+     *
+     * Samples configurations around the initial one, scores them on short
+     * lap prefixes and promotes the best third of each rung to a three
+     * times longer prefix, ending with full laps. Brackets trade how many
+     * candidates start against how short their first prefix is; the most
+     * exploratory one starts populationSize candidates on 1/27 of the lap.
+     * Each evaluated rung counts as one iteration, so maxIterations can end
+     * the schedule early; only full-lap rungs update the best configuration.
+     */
+    OptimizationResult hyperband(
+        const RobotConfig& initialConfig,
+        const std::shared_ptr<const CompiledTrack>& track,
+        std::function<void(float)> progressCallback
+    );
+
+    /**
+     * @brief NSGA-II over lap time, energy and tracking error
+     *
+     * Searches the same parameters as cmaEs, within four times each
+     * initial value, and returns the final first front in paretoFront so
+     * one run serves every weighting; optimalConfig is still the best
+     * under calculateFitness. Laps that fail count as constraint
+     * violations ranked by progress. Each generation is one parallel
+     * population, and every generation shares one noise seed so that
+     * surviving parents and new offspring are compared on the same noise.
+     * Converges once the first front gains nothing beyond tolerance for
+     * several generations in a row; a run that reaches maxIterations first
+     * is not converged. Pick tuneSpeed for a meaningful energy trade-off.
+     */
+    OptimizationResult nsga2(
+        const RobotConfig& initialConfig,
+        const std::shared_ptr<const CompiledTrack>& track,
         std::function<void(float)> progressCallback
     );
 
     /**
      * @brief Calculate numerical gradient
+     *
+     * Central differences over kp, ki, kd (and maxSpeed with tuneSpeed):
+     * the 2n perturbed runs and the centre run are one parallel population
+     * with common random numbers. A parameter closer than one step to its
+     * lower bound uses a forward difference instead, so no run probes a
+     * negative gain. Each parameter's step adapts between
+     * calls: it grows while the difference is unresolved and shrinks when
+     * curvature dominates or a perturbed run fails.
+     *
      * @param config Current configuration
-     * @param trackPoints Track definition
-     * @return Gradient vector
+     * @param track Compiled track
+     * @param noiseSeed Sensor noise seed for every run of this gradient
+     * @param centreMetrics Optional output: metrics of the unperturbed run
+     * @return Gradient vector, one entry per tuned parameter
      */
     std::vector<float> calculateGradient(
         const RobotConfig& config,
-        const std::vector<TrackPoint>& trackPoints
+        const std::shared_ptr<const CompiledTrack>& track,
+        uint32_t noiseSeed,
+        SimulationMetrics* centreMetrics = nullptr
     );
 };
 
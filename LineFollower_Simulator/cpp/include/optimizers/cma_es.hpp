@@ -0,0 +1,133 @@
+/**
+ * @file cma_es.hpp
+ * @brief Covariance Matrix Adaptation Evolution Strategy
+ *
+ * Ask/tell CMA-ES (Hansen's standard parameterization) for minimizing a
+ * noisy black-box cost over a few continuous parameters. Only the ranking
+ * of costs is used, so plateaus and cliffs (runs that fall off the track)
+ * do not produce misleading steps the way finite differences do.
+ */
+
+#ifndef CMA_ES_HPP
+#define CMA_ES_HPP
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace LineFollower {
+
+class CheckpointWriter;
+class CheckpointReader;
+
+namespace Optimizers {
+
+/**
+ * @brief Single CMA-ES run (restarts are driven by the caller)
+ */
+class CMAES {
+public:
+    /**
+     * @brief Constructor
+     * @param mean Initial distribution mean
+     * @param sigma Initial step size
+     * @param lambda Offspring per generation (0 = 4 + 3 ln n)
+     * @param seed Sampling seed
+     */
+    CMAES(const Eigen::VectorXd& mean, double sigma, int lambda, uint32_t seed);
+
+    /**
+     * @brief Sample the next generation
+     * @return lambda candidate points
+     */
+    const std::vector<Eigen::VectorXd>& ask();
+
+    /**
+     * @brief Update the distribution from the costs of the last ask()
+     * @param costs One cost per candidate, lower is better
+     */
+    void tell(const std::vector<double>& costs);
+
+    /**
+     * @brief Check the stopping criteria
+     * @param tolX Stop once every coordinate's step is below this
+     * @param tolFun Stop once recent best costs span less than this
+     * @return true if the run should stop
+     */
+    bool shouldStop(double tolX, double tolFun) const;
+
+    /**
+     * @brief Offspring per generation
+     */
+    int lambda() const { return lambda_; }
+
+    /**
+     * @brief Generations completed
+     */
+    int generation() const { return generation_; }
+
+    /**
+     * @brief Current step size
+     */
+    double sigma() const { return sigma_; }
+
+    /**
+     * @brief Current distribution mean
+     */
+    const Eigen::VectorXd& mean() const { return mean_; }
+
+    /**
+     * @brief Append the distribution and sampler state to a checkpoint
+     *
+     * Call between tell() and the next ask(); the samples themselves are
+     * not saved.
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Continue from a saved state
+     *
+     * The object must have been constructed with the same dimension and
+     * lambda as the saved one.
+     *
+     * @param in Checkpoint positioned at a save() block
+     * @return false if the block is malformed or does not match
+     */
+    bool restore(CheckpointReader& in);
+
+private:
+    int n_;
+    int lambda_;
+    int mu_;
+    Eigen::VectorXd weights_;
+    double mueff_;
+
+    // Adaptation rates
+    double cc_, cs_, c1_, cmu_, damps_, chiN_;
+
+    // Distribution state
+    Eigen::VectorXd mean_;
+    double sigma_;
+    Eigen::MatrixXd C_;
+    Eigen::MatrixXd B_;              // eigenvectors of C
+    Eigen::VectorXd D_;              // square roots of the eigenvalues
+    Eigen::MatrixXd invSqrtC_;
+    Eigen::VectorXd pc_, ps_;
+    int generation_;
+
+    // Last generation
+    std::vector<Eigen::VectorXd> samples_;
+    std::vector<double> bestHistory_;   // best cost per generation
+    std::mt19937 rng_;
+
+    /**
+     * @brief Recompute B, D and C^-1/2 from C
+     */
+    void decompose();
+};
+
+} // namespace Optimizers
+} // namespace LineFollower
+
+#endif // CMA_ES_HPP
@@ -0,0 +1,88 @@
+/**
+ * @file direct_collocation.hpp
+ * @brief Minimum-time speed along a fixed path by direct collocation
+ *
+ * For geometry no analytical strategy covers. The path is discretized into
+ * nodes and the unknowns are b = v^2 at each node, with the acceleration
+ * piecewise constant between nodes. In these variables the lap time, grip
+ * (friction circle), braking and differential-drive wheel-speed limits are
+ * all convex; only the motors' back-EMF limit is not, and an SQP outer loop
+ * relinearizes it. Each convex subproblem is solved by a barrier interior
+ * point method whose Newton systems are tridiagonal Eigen sparse matrices,
+ * warm-started from the forward-backward velocity profile.
+ */
+
+#ifndef DIRECT_COLLOCATION_HPP
+#define DIRECT_COLLOCATION_HPP
+
+#include "../simulator.hpp"
+#include <Eigen/Dense>
+#include <vector>
+
+namespace LineFollower {
+namespace Optimizers {
+
+/**
+ * @brief Direct collocation settings
+ */
+struct CollocationSettings {
+    int maxNodes;                // discretization cap along the path
+    int sqpIterations;           // motor-limit relinearizations
+    int maxNewton;               // Newton steps per barrier stage
+    double gapTolerance;         // barrier duality gap, relative to lap time
+
+    /**
+     * @brief Default settings
+     */
+    static CollocationSettings defaults() {
+        return CollocationSettings{400, 5, 50, 1e-5};
+    }
+};
+
+/**
+ * @brief Direct collocation outcome
+ */
+struct CollocationResult {
+    std::vector<float> speed;    // per node (m/s)
+    float spacing;               // arc length between nodes (m)
+    float time;                  // traversal time (s)
+    int newtonSteps;             // total Newton iterations
+    bool converged;              // every barrier stage centred, gap and lap time settled
+};
+
+/**
+ * @brief Minimum-time collocation solver for a path segment
+ */
+class DirectCollocation {
+public:
+    /**
+     * @brief Constructor
+     * @param settings Solver settings
+     */
+    explicit DirectCollocation(const CollocationSettings& settings = CollocationSettings::defaults());
+
+    /**
+     * @brief Solve over a curvature profile
+     * @param curvature Curvature per sample, uniformly spaced (1/m)
+     * @param spacing Arc length between samples (m)
+     * @param config Robot configuration
+     * @param entrySpeed Highest entry speed (m/s); negative = free
+     * @param exitSpeed Highest exit speed (m/s); negative = free
+     * @return Speeds and time; empty speeds if the segment is degenerate
+     */
+    CollocationResult solve(
+        const std::vector<float>& curvature,
+        float spacing,
+        const RobotConfig& config,
+        float entrySpeed,
+        float exitSpeed
+    ) const;
+
+private:
+    CollocationSettings settings_;
+};
+
+} // namespace Optimizers
+} // namespace LineFollower
+
+#endif // DIRECT_COLLOCATION_HPP
@@ -0,0 +1,118 @@
+/**
+ * @file lbfgs.hpp
+ * @brief Limited-memory BFGS minimizer with a strong Wolfe line search
+ *
+ * For smooth problems where each evaluation is expensive: a whole-lap
+ * parameter fit under common random numbers, or the few transition
+ * velocities of one artifact. Curvature pairs from the last iterations
+ * build a quasi-Newton direction by the two-loop recursion, so convergence
+ * takes tens of evaluations rather than hundreds.
+ */
+
+#ifndef LBFGS_HPP
+#define LBFGS_HPP
+
+#include <Eigen/Dense>
+#include <deque>
+#include <functional>
+
+namespace LineFollower {
+namespace Optimizers {
+
+/**
+ * @brief L-BFGS settings
+ */
+struct LBFGSSettings {
+    int memory;                  // curvature pairs kept
+    int maxIterations;           // outer iterations
+    int maxLineSearch;           // function evaluations per line search
+    double gradientTolerance;    // stop when max |gradient| falls below this
+    double valueTolerance;       // stop when the relative decrease falls below this
+    double c1;                   // sufficient decrease (Armijo) constant
+    double c2;                   // curvature condition constant
+
+    /**
+     * @brief Default settings
+     */
+    static LBFGSSettings defaults() {
+        return LBFGSSettings{6, 50, 20, 1e-5, 1e-7, 1e-4, 0.9};
+    }
+};
+
+/**
+ * @brief L-BFGS outcome
+ */
+struct LBFGSResult {
+    Eigen::VectorXd x;           // best point found
+    double value;                // objective at x
+    int iterations;
+    int evaluations;             // objective calls, including line searches
+    bool converged;              // stopped by a tolerance, not a limit
+};
+
+/**
+ * @brief L-BFGS minimizer
+ */
+class LBFGS {
+public:
+    /**
+     * @brief Objective: returns f(x) and writes the gradient
+     */
+    using Objective = std::function<double(const Eigen::VectorXd& x, Eigen::VectorXd& gradient)>;
+
+    /**
+     * @brief Called after each iteration; return false to stop early
+     */
+    using Monitor = std::function<bool(int iteration, double value)>;
+
+    /**
+     * @brief Constructor
+     * @param settings Solver settings
+     */
+    explicit LBFGS(const LBFGSSettings& settings = LBFGSSettings::defaults());
+
+    /**
+     * @brief Minimize from a starting point
+     * @param objective Objective and gradient
+     * @param start Starting point
+     * @param monitor Optional progress/cancellation hook
+     * @return Best point found
+     */
+    LBFGSResult minimize(const Objective& objective, const Eigen::VectorXd& start, const Monitor& monitor = nullptr);
+
+private:
+    LBFGSSettings settings_;
+    std::deque<Eigen::VectorXd> s_;   // position differences
+    std::deque<Eigen::VectorXd> y_;   // gradient differences
+
+    /**
+     * @brief Two-loop recursion: approximate -H * gradient
+     */
+    Eigen::VectorXd direction(const Eigen::VectorXd& gradient) const;
+
+    /**
+     * @brief Strong Wolfe line search along a descent direction
+     * @param objective Objective and gradient
+     * @param x Current point, replaced by the accepted point
+     * @param value Objective at x, updated
+     * @param gradient Gradient at x, updated
+     * @param direction Descent direction
+     * @param step Initial trial step
+     * @param evaluations Incremented per objective call
+     * @return true if a point satisfying the Wolfe conditions was accepted
+     */
+    bool lineSearch(
+        const Objective& objective,
+        Eigen::VectorXd& x,
+        double& value,
+        Eigen::VectorXd& gradient,
+        const Eigen::VectorXd& direction,
+        double step,
+        int& evaluations
+    ) const;
+};
+
+} // namespace Optimizers
+} // namespace LineFollower
+
+#endif // LBFGS_HPP
@@ -0,0 +1,129 @@
+/**
+ * @file mpc.hpp
+ * @brief Model predictive line-tracking controller
+ *
+ * Short-horizon tracking of the line and a reference speed profile with the
+ * differential-drive model linearized about the current speed. States are
+ * lateral offset, heading error and the two wheel speeds; inputs are the two
+ * motor commands. The problem is condensed to a fixed-size box-constrained QP
+ * over the horizon's commands and solved by accelerated projected gradient,
+ * warm-started from the previous tick's solution shifted by one stage.
+ *
+ * Everything lives in fixed-size Eigen members, so a solve allocates
+ * nothing. A per-tick time budget and an iteration cap bound the cost; when
+ * the budget runs out the caller falls back to its PID output.
+ */
+
+#ifndef MPC_HPP
+#define MPC_HPP
+
+#include <Eigen/Dense>
+#include <array>
+
+namespace LineFollower {
+namespace Optimizers {
+
+/**
+ * @brief MPC settings
+ */
+struct MPCSettings {
+    float horizonStep;       // prediction step (s)
+    int maxIterations;       // projected-gradient iterations per tick
+    float budgetMicros;      // wall-clock budget per tick (us, 0 = none)
+    float tolerance;         // stop when no command moves more than this
+    float lateralWeight;     // per m² of lateral offset
+    float headingWeight;     // per rad² of heading error
+    float speedWeight;       // per (m/s)² below or above the reference
+    float smoothWeight;      // per unit² of command change between stages
+
+    /**
+     * @brief Default settings
+     */
+    static MPCSettings defaults() {
+        return MPCSettings{0.02f, 50, 50.0f, 1e-4f, 4000.0f, 20.0f, 2.0f, 0.05f};
+    }
+};
+
+/**
+ * @brief Horizon length and problem size
+ */
+constexpr int MPC_HORIZON = 10;
+constexpr int MPC_STATES = 4;
+constexpr int MPC_CONTROLS = 2;
+constexpr int MPC_VARIABLES = MPC_HORIZON * MPC_CONTROLS;
+
+/**
+ * @brief Measurements and previews for one tick
+ */
+struct MPCInput {
+    float lateralError;      // m, positive with the robot left of the line
+    float headingError;      // rad, robot heading minus line heading
+    float leftSpeed;         // wheel speeds (m/s)
+    float rightSpeed;
+    float leftCommand;       // commands applied on the previous tick
+    float rightCommand;
+    std::array<float, MPC_HORIZON> curvature;        // line curvature at each stage
+    std::array<float, MPC_HORIZON> referenceSpeed;   // target speed at each stage
+};
+
+/**
+ * @brief Model predictive controller
+ */
+class MPC {
+public:
+    /**
+     * @brief Constructor
+     * @param settings Controller settings
+     * @param wheelbase Distance between wheels (m)
+     * @param maxSpeed Free-running wheel speed at full command (m/s)
+     * @param wheelAcceleration Wheel acceleration at stall (m/s²)
+     */
+    MPC(const MPCSettings& settings, float wheelbase, float maxSpeed, float wheelAcceleration);
+
+    /**
+     * @brief Solve this tick's problem
+     * @param input Measurements and previews
+     * @param leftCommand Left motor command (0 to 1), written on success
+     * @param rightCommand Right motor command (0 to 1), written on success
+     * @return false if the time budget ran out; use the fallback command
+     */
+    bool solve(const MPCInput& input, float& leftCommand, float& rightCommand);
+
+    /**
+     * @brief Forget the warm start
+     */
+    void reset();
+
+    /**
+     * @brief Iterations used by the last solve
+     */
+    int lastIterations() const { return iterations_; }
+
+private:
+    using Commands = Eigen::Matrix<float, MPC_VARIABLES, 1>;
+    using Hessian = Eigen::Matrix<float, MPC_VARIABLES, MPC_VARIABLES>;
+    using Prediction = Eigen::Matrix<float, MPC_HORIZON * MPC_STATES, MPC_VARIABLES>;
+    using Trajectory = Eigen::Matrix<float, MPC_HORIZON * MPC_STATES, 1>;
+
+    MPCSettings settings_;
+    float wheelbase_;
+    float maxSpeed_;
+    float lag_;              // wheel speed decay per prediction step
+    float gain_;             // wheel speed gained per unit command per step
+
+    Prediction gamma_;       // stacked states per unit command
+    Prediction weighted_;    // stage cost times gamma_
+    Trajectory free_;        // stacked states with zero commands
+    Hessian hessian_;
+    Commands linear_;
+    Commands commands_;      // warm start / current iterate
+    Commands previous_;
+    Commands momentum_;
+    bool warm_;
+    int iterations_;
+};
+
+} // namespace Optimizers
+} // namespace LineFollower
+
+#endif // MPC_HPP
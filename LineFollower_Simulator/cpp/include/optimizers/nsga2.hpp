@@ -0,0 +1,202 @@
+/**
+ * @file nsga2.hpp
+ * @brief Non-dominated Sorting Genetic Algorithm II
+ *
+ * Ask/tell NSGA-II (Deb et al. 2002) for minimizing several objectives at
+ * once over a few bounded continuous parameters. Each generation the
+ * parents and their offspring are sorted into non-dominated fronts, and
+ * the next parents are the best fronts, with the last one truncated by
+ * crowding distance so the survivors spread along the trade-off. Offspring
+ * come from binary tournaments, simulated binary crossover and polynomial
+ * mutation. Constraints follow Deb's rule: a feasible point beats an
+ * infeasible one, and of two infeasible points the smaller violation wins.
+ */
+
+#ifndef NSGA2_HPP
+#define NSGA2_HPP
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace LineFollower {
+
+class CheckpointWriter;
+class CheckpointReader;
+
+namespace Optimizers {
+
+/**
+ * @brief Variation operator settings
+ */
+struct NSGA2Settings {
+    double crossoverProbability;   // chance a pair is recombined
+    double crossoverEta;           // SBX distribution index (larger = children nearer parents)
+    double mutationEta;            // polynomial mutation distribution index
+    double mutationProbability;    // per variable; 0 = 1 / n
+
+    static NSGA2Settings defaults() {
+        return NSGA2Settings{0.9, 15.0, 20.0, 0.0};
+    }
+};
+
+/**
+ * @brief Single NSGA-II run over a box
+ */
+class NSGA2 {
+public:
+    /**
+     * @brief Constructor
+     * @param start Point included in the first generation
+     * @param lower Lower bound per variable
+     * @param upper Upper bound per variable
+     * @param populationSize Parents per generation (rounded up to even, at least 4)
+     * @param seed Sampling seed
+     * @param settings Variation operator settings
+     */
+    NSGA2(
+        const Eigen::VectorXd& start,
+        const Eigen::VectorXd& lower,
+        const Eigen::VectorXd& upper,
+        int populationSize,
+        uint32_t seed,
+        const NSGA2Settings& settings = NSGA2Settings::defaults()
+    );
+
+    /**
+     * @brief Candidates of the next generation
+     *
+     * The first call returns the start point and uniform samples of the
+     * box; later calls return offspring of the current parents.
+     *
+     * @return populationSize candidate points
+     */
+    const std::vector<Eigen::VectorXd>& ask();
+
+    /**
+     * @brief Select the next parents from the results of the last ask()
+     * @param objectives One vector per candidate, every entry minimized
+     * @param violations Constraint violation per candidate (0 = feasible)
+     */
+    void tell(const std::vector<Eigen::VectorXd>& objectives, const std::vector<double>& violations);
+
+    /**
+     * @brief Parents selected by the last tell()
+     */
+    const std::vector<Eigen::VectorXd>& population() const { return parents_; }
+
+    /**
+     * @brief Objectives of each parent
+     */
+    const std::vector<Eigen::VectorXd>& objectives() const { return objectives_; }
+
+    /**
+     * @brief Parents that are feasible and in the first front
+     * @return Indices into population()
+     */
+    std::vector<int> front() const;
+
+    /**
+     * @brief Parents per generation
+     */
+    int populationSize() const { return size_; }
+
+    /**
+     * @brief Generations told so far
+     */
+    int generation() const { return generation_; }
+
+    /**
+     * @brief Append the parents and sampler state to a checkpoint
+     *
+     * Call between tell() and the next ask().
+     */
+    void save(CheckpointWriter& out) const;
+
+    /**
+     * @brief Continue from a saved state
+     *
+     * The object must have been constructed with the same dimension and
+     * population size as the saved one.
+     *
+     * @param in Checkpoint positioned at a save() block
+     * @return false if the block is malformed or does not match
+     */
+    bool restore(CheckpointReader& in);
+
+private:
+    int n_;
+    int size_;
+    Eigen::VectorXd lower_;
+    Eigen::VectorXd upper_;
+    Eigen::VectorXd start_;
+    NSGA2Settings settings_;
+    int generation_;
+    std::mt19937 rng_;
+
+    // Current parents, with the rank and crowding that drive selection
+    std::vector<Eigen::VectorXd> parents_;
+    std::vector<Eigen::VectorXd> objectives_;
+    std::vector<double> violations_;
+    std::vector<int> rank_;
+    std::vector<double> crowding_;
+
+    // Last ask()
+    std::vector<Eigen::VectorXd> offspring_;
+
+    /**
+     * @brief Whether a is preferred to b under constrained domination
+     */
+    static bool dominates(
+        const Eigen::VectorXd& a, double violationA,
+        const Eigen::VectorXd& b, double violationB
+    );
+
+    /**
+     * @brief Fast non-dominated sort
+     * @return Fronts of indices, best first
+     */
+    static std::vector<std::vector<int>> sortFronts(
+        const std::vector<Eigen::VectorXd>& objectives,
+        const std::vector<double>& violations
+    );
+
+    /**
+     * @brief Crowding distance of each member of one front
+     * @param objectives Objectives of the whole pool
+     * @param front Indices of the front
+     * @param distance Output, indexed like the pool
+     */
+    static void crowdingDistance(
+        const std::vector<Eigen::VectorXd>& objectives,
+        const std::vector<int>& front,
+        std::vector<double>& distance
+    );
+
+    /**
+     * @brief Recompute rank and crowding of the current parents
+     */
+    void rankParents();
+
+    /**
+     * @brief Binary tournament on rank, then crowding
+     * @return Index of the winning parent
+     */
+    int tournament();
+
+    /**
+     * @brief Simulated binary crossover of two parents, in place
+     */
+    void crossover(Eigen::VectorXd& a, Eigen::VectorXd& b);
+
+    /**
+     * @brief Polynomial mutation, in place
+     */
+    void mutate(Eigen::VectorXd& x);
+};
+
+} // namespace Optimizers
+} // namespace LineFollower
+
+#endif // NSGA2_HPP
@@ -15,6 +15,8 @@
 
 namespace LineFollower {
 
+class CompiledTrack;
+
 /**
  * @brief Artifact types
  */
@@ -40,6 +42,11 @@ struct Artifact {
     float length;         // Total length in meters
     float curvature;      // Average curvature (0 for straight)
     float radius;         // Radius for circular curves
+    float turnAngle;      // Total absolute heading change (rad)
+    float peakCurvature;  // Largest absolute curvature (1/m)
+    float entryCurvature; // Absolute curvature where the artifact starts (1/m)
+    float exitCurvature;  // Absolute curvature where the artifact ends (1/m)
+    int lobes;            // Curves of alternating direction (0 for straight)
     std::string description;
 };
 
@@ -63,6 +70,19 @@ public:
         const std::vector<TrackPoint>& trackPoints
     );
 
+    /**
+     * @brief Analyze a compiled track and identify artifacts
+     *
+     * Works on the resampled curvature: samples are split into straight and
+     * turning runs, curves without a straight between them are grouped, and
+     * each group is matched from most to least specific. Artifacts tile the
+     * track and share their boundary points; unmatched curves are COMPLEX.
+     *
+     * @param track Compiled track
+     * @return Vector of identified artifacts
+     */
+    std::vector<Artifact> recognizeArtifacts(const CompiledTrack& track);
+
     /**
      * @brief Set recognition tolerances
      * @param straightTolerance Maximum curvature for straight detection
@@ -74,11 +94,58 @@ private:
     float straightTolerance_;
     float circleTolerance_;
 
+    /**
+     * @brief Run of equally labelled samples (0 straight, +-1 turn direction)
+     */
+    struct Run {
+        int label;
+        int start;
+        int end;
+    };
+
+    /**
+     * @brief Original point nearest to an arc length
+     */
+    int nearestPoint(const CompiledTrack& track, float arcLength) const;
+
+    /**
+     * @brief Absolute curvature statistics over a sample range
+     */
+    struct CurveStats {
+        float length;
+        float turnAngle;
+        float meanCurvature;
+        float peakCurvature;
+        float entryCurvature;
+        float exitCurvature;
+    };
+
+    /**
+     * @brief Build one artifact over a sample range (1+ same-sign runs)
+     */
+    Artifact classify(
+        const CompiledTrack& track,
+        int start,
+        int end,
+        int lobes
+    ) const;
+
+    /**
+     * @brief Curvature statistics over samples [start, end]
+     */
+    CurveStats curveStats(
+        const CompiledTrack& track,
+        int start,
+        int end
+    ) const;
+
+    // Segment checks below take compiled-track sample ranges [start, end]
+
     /**
      * @brief Check if segment is straight
      */
     bool isStraight(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
         int start,
         int end
     ) const;
@@ -87,7 +154,7 @@ private:
      * @brief Check if segment is circular curve
      */
     bool isCircularCurve(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
         int start,
         int end,
         float& radius
@@ -97,7 +164,7 @@ private:
      * @brief Check if segment is S-curve
      */
     bool isSCurve(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
         int start,
         int end
     ) const;
@@ -106,16 +173,25 @@ private:
      * @brief Check if segment is hairpin
      */
     bool isHairpin(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
+        int start,
+        int end
+    ) const;
+
+    /**
+     * @brief Check if segment is spiral (curvature changing steadily)
+     */
+    bool isSpiral(
+        const CompiledTrack& track,
         int start,
         int end
     ) const;
 
     /**
-     * @brief Calculate curvature at segment
+     * @brief Calculate curvature at a track point (signed, positive turning left)
      */
     float calculateSegmentCurvature(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
         int index
     ) const;
 
@@ -123,7 +199,7 @@ private:
      * @brief Calculate segment length
      */
     float calculateSegmentLength(
-        const std::vector<TrackPoint>& points,
+        const CompiledTrack& track,
         int start,
         int end
     ) const;
@@ -10,6 +10,7 @@
 #define PHYSICS_HPP
 
 #include <cmath>
+#include <cstdint>
 
 namespace LineFollower {
 namespace Physics {
@@ -21,6 +22,16 @@ constexpr float PI = 3.14159265359f;
 constexpr float DEG_TO_RAD = PI / 180.0f;
 constexpr float RAD_TO_DEG = 180.0f / PI;
 
+/**
+ * @brief Robot and track model constants
+ */
+constexpr float LINE_WIDTH = 0.019f;           // competition line width (m)
+constexpr float SENSOR_ARRAY_OFFSET = 0.08f;   // sensor bar distance ahead of the wheel axle (m)
+constexpr float MOTOR_STALL_TORQUE = 0.1f;     // per motor at the wheel shaft (N·m)
+constexpr float MOTOR_STALL_CURRENT = 1.6f;    // per motor (A)
+constexpr float SUPPLY_VOLTAGE = 12.0f;        // battery voltage (V)
+constexpr float INTEGRATION_SUBSTEP = 0.001f;  // maximum physics substep (s)
+
 /**
  * @brief 2D vector structure
  */
@@ -106,6 +117,104 @@ inline float angleDifference(float from, float to) {
     return normalizeAngle(diff);
 }
 
+/**
+ * @brief Squared distance from a point to a segment
+ * @param px Point x
+ * @param py Point y
+ * @param ax Segment start x
+ * @param ay Segment start y
+ * @param bx Segment end x
+ * @param by Segment end y
+ * @param[out] t Projection parameter along the segment, clamped to [0, 1]
+ * @return Squared distance (m²)
+ */
+inline float pointSegmentDistanceSq(
+    float px, float py,
+    float ax, float ay,
+    float bx, float by,
+    float& t)
+{
+    float dx = bx - ax;
+    float dy = by - ay;
+    float lenSq = dx * dx + dy * dy;
+    t = 0.0f;
+    if (lenSq > 1e-12f) {
+        t = clamp(((px - ax) * dx + (py - ay) * dy) / lenSq, 0.0f, 1.0f);
+    }
+    float ex = ax + t * dx - px;
+    float ey = ay + t * dy - py;
+    return ex * ex + ey * ey;
+}
+
+/**
+ * @brief Simulated IR reflectance for a sensor at a distance from the line
+ * @param distance Distance from sensor to line centre (m)
+ * @param sensorHeight Sensor height above ground (m)
+ * @return Reading in [0, 1], 1 when centred over the line
+ */
+inline float sensorResponse(float distance, float sensorHeight) {
+    // The sensing spot widens with mounting height
+    float sigma = 0.5f * LINE_WIDTH + sensorHeight;
+    float r = distance / sigma;
+    return std::exp(-0.5f * r * r);
+}
+
+/**
+ * @brief Distance beyond which a sensor no longer sees the line
+ * @param sensorHeight Sensor height above ground (m)
+ * @return Range (m); sensorResponse is below 1e-5 past it
+ */
+inline float sensorRange(float sensorHeight) {
+    return 5.0f * (0.5f * LINE_WIDTH + sensorHeight);
+}
+
+/**
+ * @brief Initial noise generator state for a seed (never zero)
+ */
+inline uint32_t noiseState(uint32_t seed) {
+    uint32_t state = seed ^ 0x9E3779B9u;
+    return state != 0 ? state : 1u;
+}
+
+/**
+ * @brief Zero-mean uniform noise with unit standard deviation
+ *
+ * xorshift32 step: the same seed always yields the same sequence, which is
+ * what lets finite differences share noise between runs.
+ *
+ * @param state Generator state, updated in place (from noiseState)
+ * @return Sample in [-sqrt(3), sqrt(3))
+ */
+inline float uniformNoise(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    float unit = static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    return 1.7320508f * (2.0f * unit - 1.0f);
+}
+
+/**
+ * @brief Wheel acceleration for a DC motor with a linear torque-speed curve
+ * @param command Motor command (-1 to 1)
+ * @param wheelSpeed Current wheel ground speed (m/s)
+ * @param maxSpeed No-load ground speed at full command (m/s)
+ * @param stallForce Ground force at stall (N)
+ * @param wheelMass Mass carried by the wheel (kg)
+ * @param traction Maximum tractive acceleration (m/s²)
+ * @return Wheel acceleration (m/s²)
+ */
+inline float motorAcceleration(
+    float command,
+    float wheelSpeed,
+    float maxSpeed,
+    float stallForce,
+    float wheelMass,
+    float traction)
+{
+    float force = stallForce * (command - wheelSpeed / maxSpeed);
+    return clamp(force / wheelMass, -traction, traction);
+}
+
 /**
  * @brief Calculate curvature at a point on a path
  * @param prev Previous point
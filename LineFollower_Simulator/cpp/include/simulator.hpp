@@ -2,22 +2,50 @@
  * @file simulator.hpp
  * @brief Main simulator class - handles physics simulation and state management
  *
- * This class integrates Box2D physics engine to simulate realistic robot dynamics
- * including differential drive kinematics, sensor readings, and environmental factors.
+ * Simulates realistic robot dynamics with a fixed-substep differential drive
+ * integrator, IR sensor readings against the track line, and environmental factors.
+ * The per-step path performs no heap allocations.
  */
 
 #ifndef SIMULATOR_HPP
 #define SIMULATOR_HPP
 
 #include <vector>
+#include <array>
 #include <memory>
-
-// Forward declarations
-class b2World;
-class b2Body;
+#include <cstddef>
+#include <cstdint>
 
 namespace LineFollower {
 
+class CompiledTrack;
+class DistanceField;
+class VelocityProfile;
+
+namespace Optimizers {
+class MPC;
+struct MPCSettings;
+}
+
+/**
+ * @brief Maximum number of line sensors supported
+ */
+constexpr int MAX_SENSORS = 16;
+
+/**
+ * @brief Controller and track-following constants shared by the simulators
+ */
+constexpr float BASE_POWER = 0.5f;            // motor command when the line is centred
+constexpr float LINE_LOST_THRESHOLD = 0.05f;  // total reflectance below which the line is lost
+constexpr int PROGRESS_SEARCH_WINDOW = 8;     // segments searched ahead when tracking progress
+
+/**
+ * @brief Recorded frame layout for Simulator::run (floats per frame)
+ *
+ * time, posX, posY, heading, leftMotor, rightMotor, lineError, power
+ */
+constexpr int FRAME_STRIDE = 8;
+
 /**
  * @brief Robot configuration structure
  */
@@ -40,7 +68,7 @@ struct RobotConfig {
 };
 
 /**
- * @brief Track point structure
+ * @brief Track point structure (meters)
  */
 struct TrackPoint {
     float x, y;
@@ -54,7 +82,8 @@ struct RobotState {
     float velX, velY;        // velocity
     float heading;           // radians
     float angularVel;        // rad/s
-    std::vector<float> sensorReadings;  // 0-1 values
+    std::array<float, MAX_SENSORS> sensorReadings;  // 0-1 values
+    int sensorCount;         // valid entries in sensorReadings
     float leftMotor;         // PWM value
     float rightMotor;        // PWM value
     float lineError;         // current line following error
@@ -62,6 +91,103 @@ struct RobotState {
     float time;              // simulation time
 };
 
+/**
+ * @brief Why a run was stopped early
+ */
+enum class FailureReason {
+    NONE,
+    OFF_TRACK,            // line outside the sensor array for too long
+    STALLED,              // no progress along the track for too long
+    REVERSED,             // heading turned against the track direction
+    CUTOFF,               // cannot finish before the caller's cutoff time
+    TIMEOUT               // absolute time limit reached
+};
+
+/**
+ * @brief Early-abort thresholds
+ */
+struct FailureCriteria {
+    float offTrackTime;      // s the line may stay outside the sensor array
+    float stallTime;         // s allowed without minProgress of arc length
+    float minProgress;       // m of progress that resets the stall timer
+    float maxHeadingError;   // rad between heading and track direction
+    float cutoffTime;        // fail once completion cannot beat this (s); 0 disables
+    float timeout;           // absolute simulated time limit (s)
+
+    /**
+     * @brief Default thresholds
+     */
+    static FailureCriteria defaults() {
+        return FailureCriteria{0.25f, 1.0f, 0.01f, 2.35f, 0.0f, 120.0f};
+    }
+};
+
+/**
+ * @brief Progress and failure timers of a running robot
+ *
+ * Shared by Simulator and SimulatorBatch so both abort identically.
+ */
+struct ProgressMonitor {
+    float progress;          // arc length of the robot's projection (m)
+    float stallProgress;     // arc length when the stall timer was last reset (m)
+    float stallStart;        // time of the last reset (s)
+    float offTrackTime;      // continuous time with the line outside the array (s)
+    FailureReason reason;
+
+    /**
+     * @brief Clear timers for a new run
+     */
+    void reset();
+
+    /**
+     * @brief Update timers after a step and test the failure criteria
+     * @param criteria Thresholds
+     * @param time Simulation time after the step (s)
+     * @param dt Step length (s)
+     * @param arcLength Robot's projection on the track (m)
+     * @param trackLength Total track length (m)
+     * @param lineDistance Distance from sensor bar centre to the line (m)
+     * @param offTrackDistance lineDistance above which the line is outside the array (m)
+     * @param headingAlignment Cosine between heading and track direction
+     * @param maxSpeed Robot top speed, for the optimistic completion bound (m/s)
+     * @return Failure reason, NONE while the robot may continue
+     */
+    FailureReason update(
+        const FailureCriteria& criteria,
+        float time,
+        float dt,
+        float arcLength,
+        float trackLength,
+        float lineDistance,
+        float offTrackDistance,
+        float headingAlignment,
+        float maxSpeed
+    );
+};
+
+/**
+ * @brief Complete dynamic state of a simulation
+ *
+ * Plain-old-data checkpoint used to fork many continuations from a shared
+ * prefix. Configuration and track are not included: a snapshot can be
+ * restored into any simulator built on the same track.
+ */
+struct SimulatorSnapshot {
+    RobotState state;
+    float leftWheelSpeed;    // m/s
+    float rightWheelSpeed;   // m/s
+    int trackSegment;
+    float simulationTime;
+    float completionTime;
+    float prevError;
+    float errorIntegral;
+    float relayOutput;
+    uint32_t noiseState;
+    ProgressMonitor monitor;
+    bool isComplete;
+    bool hasFailed;
+};
+
 /**
  * @brief Main simulator class
  */
@@ -70,10 +196,21 @@ public:
     /**
      * @brief Constructor
      * @param config Robot configuration
-     * @param trackPoints Track definition points
+     * @param trackPoints Track definition points (compiled into a private track)
      */
     Simulator(const RobotConfig& config, const std::vector<TrackPoint>& trackPoints);
 
+    /**
+     * @brief Constructor sharing an already compiled track
+     *
+     * The track is immutable, so any number of simulators (on any number of
+     * threads) can read the same copy.
+     *
+     * @param config Robot configuration
+     * @param track Compiled track
+     */
+    Simulator(const RobotConfig& config, std::shared_ptr<const CompiledTrack> track);
+
     /**
      * @brief Destructor
      */
@@ -91,16 +228,44 @@ public:
      */
     void step(float dt);
 
+    /**
+     * @brief Run until completion, failure or a time limit
+     *
+     * Steps internally and records every decimation-th state (plus the final
+     * one) into a caller-owned buffer, FRAME_STRIDE floats per frame.
+     * Frames beyond maxFrames are dropped; the run itself continues.
+     *
+     * @param dt Time step in seconds
+     * @param maxTime Simulated time limit in seconds
+     * @param decimation Record one frame every this many steps
+     * @param frames Output buffer of maxFrames * FRAME_STRIDE floats
+     * @param maxFrames Frame capacity of the buffer
+     * @return Number of frames written
+     */
+    int run(float dt, float maxTime, int decimation, float* frames, int maxFrames);
+
     /**
      * @brief Reset simulation to initial state
      */
     void reset();
 
+    /**
+     * @brief Capture the full simulation state
+     * @return Snapshot that restoreState accepts
+     */
+    SimulatorSnapshot saveState() const;
+
+    /**
+     * @brief Return to a previously captured state
+     * @param snapshot State from saveState on a simulator with the same track
+     */
+    void restoreState(const SimulatorSnapshot& snapshot);
+
     /**
      * @brief Get current robot state
-     * @return Current state
+     * @return Current state (valid until the next step or reset)
      */
-    RobotState getCurrentState() const;
+    const RobotState& getCurrentState() const;
 
     /**
      * @brief Check if robot completed the track
@@ -114,12 +279,44 @@ public:
      */
     bool hasFailed() const;
 
+    /**
+     * @brief Reason the run failed
+     * @return FailureReason::NONE unless hasFailed()
+     */
+    FailureReason getFailureReason() const;
+
     /**
      * @brief Get completion time
      * @return Time in seconds, or -1 if not completed
      */
     float getCompletionTime() const;
 
+    /**
+     * @brief Arc length of the robot's projection on the track (m)
+     */
+    float getProgress() const { return monitor_.progress; }
+
+    /**
+     * @brief Set early-abort thresholds
+     * @param criteria Thresholds; cutoffTime is typically the best time so far
+     */
+    void setFailureCriteria(const FailureCriteria& criteria);
+
+    /**
+     * @brief Get early-abort thresholds
+     */
+    const FailureCriteria& getFailureCriteria() const { return failureCriteria_; }
+
+    /**
+     * @brief Robot configuration in use
+     */
+    const RobotConfig& getConfig() const { return config_; }
+
+    /**
+     * @brief Compiled track shared by this simulator
+     */
+    const CompiledTrack& getTrack() const { return *track_; }
+
     /**
      * @brief Update PID gains (for online tuning)
      * @param kp Proportional gain
@@ -128,16 +325,92 @@ public:
      */
     void updatePIDGains(float kp, float ki, float kd);
 
-private:
-    // Physics world
-    std::unique_ptr<b2World> world_;
+    /**
+     * @brief Sample sensors from a precomputed distance field
+     *
+     * Replaces the geometric distance query with a bilinear fetch from a
+     * lazily rasterized field. Can be called before or after initialize.
+     *
+     * @param resolution Field sample spacing in meters (0 disables the field)
+     * @param memoryLimit Maximum bytes of resident field tiles (0 = unlimited)
+     */
+    void setDistanceField(float resolution, size_t memoryLimit);
+
+    /**
+     * @brief Add seeded noise to the sensor readings
+     *
+     * The sequence restarts from the seed on every reset, so two simulators
+     * with the same seed see identical noise (common random numbers).
+     *
+     * @param stddev Standard deviation of the added noise (0 disables)
+     * @param seed Noise seed
+     */
+    void setSensorNoise(float stddev, uint32_t seed);
+
+    /**
+     * @brief Replace the PID output with a relay (for autotuning)
+     *
+     * The control output is +amplitude or -amplitude, switching sign only
+     * once the line error crosses the hysteresis band on the other side.
+     * The PID state keeps updating underneath.
+     *
+     * @param amplitude Relay output in PID control units (0 disables)
+     * @param hysteresis Half-width of the switching band in line-error units
+     */
+    void setRelayFeedback(float amplitude, float hysteresis);
+
+    /**
+     * @brief Drive with the model predictive controller instead of the PID
+     *
+     * The MPC tracks the minimum-time speed profile using the robot's true
+     * pose relative to the line, so it measures the lap time a controller
+     * could reach rather than what the sensor-only firmware can. The PID
+     * keeps running alongside and drives on any tick where the MPC misses
+     * its time budget; with a wall-clock budget set, runs are therefore not
+     * exactly reproducible. Can be called before or after initialize.
+     *
+     * @param settings Controller settings
+     */
+    void enableMPC(const Optimizers::MPCSettings& settings);
 
-    // Robot body
-    b2Body* robotBody_;
+    /**
+     * @brief Return to the PID controller
+     */
+    void disableMPC();
 
+    /**
+     * @brief Ticks since reset on which the MPC fell back to the PID
+     */
+    int getMPCFallbacks() const { return mpcFallbacks_; }
+
+private:
     // Configuration
     RobotConfig config_;
-    std::vector<TrackPoint> trackPoints_;
+
+    // Compiled geometry and segment index, possibly shared with other simulators
+    std::shared_ptr<const CompiledTrack> track_;
+
+    // Optional rasterized sensor field
+    std::unique_ptr<DistanceField> distanceField_;
+    float fieldResolution_;
+    size_t fieldMemoryLimit_;
+
+    // Derived parameters (computed in initialize)
+    float stallForce_;       // ground force per wheel at stall (N)
+    float traction_;         // maximum tractive acceleration (m/s²)
+    float sensorRange_;      // distance beyond which sensors read zero (m)
+
+    // Sensor noise
+    float sensorNoise_;      // standard deviation added to each reading
+    uint32_t noiseSeed_;
+    uint32_t noiseState_;
+
+    // Drive state
+    float leftWheelSpeed_;   // m/s
+    float rightWheelSpeed_;  // m/s
+
+    // Track progress
+    int trackSegment_;       // segment currently being followed
 
     // State tracking
     RobotState currentState_;
@@ -150,11 +423,42 @@ private:
     float prevError_;
     float errorIntegral_;
 
+    // Optional relay replacing the PID output
+    float relayAmplitude_;
+    float relayHysteresis_;
+    float relayOutput_;      // current relay sign (+1 / -1, 0 before the first step)
+
+    // Optional model predictive controller and its reference speeds
+    std::unique_ptr<Optimizers::MPC> mpc_;
+    std::unique_ptr<VelocityProfile> mpcReference_;
+    float mpcStep_;
+    int mpcFallbacks_;
+
+    // Early-abort detection
+    FailureCriteria failureCriteria_;
+    ProgressMonitor monitor_;
+
+    /**
+     * @brief Write current state as one recorded frame
+     */
+    void writeFrame(float* frame) const;
+
     /**
      * @brief Update sensor readings based on current position
      */
     void updateSensors();
 
+    /**
+     * @brief Integrate drive dynamics in fixed substeps
+     * @param dt Time step in seconds
+     */
+    void integrate(float dt);
+
+    /**
+     * @brief Advance the followed segment to the one nearest the robot
+     */
+    void updateTrackProgress();
+
     /**
      * @brief Calculate PID control output
      * @param error Current line error
@@ -163,6 +467,13 @@ private:
      */
     float calculatePID(float error, float dt);
 
+    /**
+     * @brief Replace the motor commands with the MPC's, if it is enabled
+     * @param leftPower Left motor power, overwritten when the MPC succeeds
+     * @param rightPower Right motor power, overwritten when the MPC succeeds
+     */
+    void applyMPC(float& leftPower, float& rightPower);
+
     /**
      * @brief Apply motor commands to robot
      * @param leftPower Left motor power (-1 to 1)
@@ -183,8 +494,9 @@ private:
 
     /**
      * @brief Check failure conditions
+     * @param dt Time step just taken
      */
-    void checkFailure();
+    void checkFailure(float dt);
 };
 
 } // namespace LineFollower
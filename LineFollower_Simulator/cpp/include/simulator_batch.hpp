@@ -0,0 +1,231 @@
+/**
+ * @file simulator_batch.hpp
+ * @brief Batch simulator - steps many robot configurations in lockstep
+ *
+ * Keeps N robots in structure-of-arrays form and advances all of them over
+ * one shared copy of the track. The drive model matches Simulator, so a robot
+ * in the batch produces the same trajectory as a scalar Simulator with the
+ * same configuration.
+ */
+
+#ifndef SIMULATOR_BATCH_HPP
+#define SIMULATOR_BATCH_HPP
+
+#include <algorithm>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "simulator.hpp"
+#include "compiled_track.hpp"
+#include "distance_field.hpp"
+
+namespace LineFollower {
+
+/**
+ * @brief Structure-of-arrays simulator for many configurations on one track
+ */
+class SimulatorBatch {
+public:
+    /**
+     * @brief Constructor
+     * @param configs Robot configurations, one per robot
+     * @param trackPoints Track definition points
+     */
+    SimulatorBatch(const std::vector<RobotConfig>& configs, const std::vector<TrackPoint>& trackPoints);
+
+    /**
+     * @brief Constructor sharing an already compiled track
+     * @param configs Robot configurations, one per robot
+     * @param track Compiled track
+     */
+    SimulatorBatch(const std::vector<RobotConfig>& configs, std::shared_ptr<const CompiledTrack> track);
+
+    /**
+     * @brief Initialize simulation
+     * @return true if successful
+     */
+    bool initialize();
+
+    /**
+     * @brief Step all running robots forward by timestep
+     * @param dt Time step in seconds
+     */
+    void step(float dt);
+
+    /**
+     * @brief Reset all robots to initial state
+     */
+    void reset();
+
+    /**
+     * @brief Sample sensors from a precomputed distance field
+     * @param resolution Field sample spacing in meters (0 disables the field)
+     * @param memoryLimit Maximum bytes of resident field tiles (0 = unlimited)
+     * @see Simulator::setDistanceField
+     */
+    void setDistanceField(float resolution, size_t memoryLimit);
+
+    /**
+     * @brief Set early-abort thresholds for every robot
+     * @see Simulator::setFailureCriteria
+     */
+    void setFailureCriteria(const FailureCriteria& criteria) { failureCriteria_ = criteria; }
+
+    /**
+     * @brief Count robots as complete once they cover this much track
+     * @param arcLength Distance along the track (m); 0 = full lap only
+     */
+    void setFinishDistance(float arcLength) { finishDistance_ = std::max(0.0f, arcLength); }
+
+    /**
+     * @brief Add seeded sensor noise, the same sequence for every robot
+     * @param stddev Standard deviation of the added noise (0 disables)
+     * @param seed Noise seed
+     * @see Simulator::setSensorNoise
+     */
+    void setSensorNoise(float stddev, uint32_t seed);
+
+    /**
+     * @brief Number of robots in the batch
+     */
+    int size() const { return count_; }
+
+    /**
+     * @brief Check if every robot has completed or failed
+     */
+    bool isDone() const { return running_ == 0; }
+
+    /**
+     * @brief Check if robot completed the track
+     */
+    bool isComplete(int index) const { return isComplete_[index] != 0; }
+
+    /**
+     * @brief Check if robot failed
+     */
+    bool hasFailed(int index) const { return hasFailed_[index] != 0; }
+
+    /**
+     * @brief Reason the robot failed
+     */
+    FailureReason getFailureReason(int index) const { return monitors_[index].reason; }
+
+    /**
+     * @brief Get completion time
+     * @return Time in seconds, or -1 if not completed
+     */
+    float getCompletionTime(int index) const { return completionTime_[index]; }
+
+    /**
+     * @brief Simulated time the robot was running (s)
+     */
+    float getElapsedTime(int index) const { return elapsedTime_[index]; }
+
+    /**
+     * @brief Arc length of the robot's projection on the track (m)
+     */
+    float getProgress(int index) const { return monitors_[index].progress; }
+
+    /**
+     * @brief Integral of absolute line error over time
+     */
+    float getTrackError(int index) const { return trackError_[index]; }
+
+    /**
+     * @brief Integral of electrical power over time (J)
+     */
+    float getEnergy(int index) const { return energy_[index]; }
+
+    /**
+     * @brief Distance travelled (m)
+     */
+    float getDistance(int index) const { return distance_[index]; }
+
+    /**
+     * @brief Current position and heading
+     */
+    float getPosX(int index) const { return posX_[index]; }
+    float getPosY(int index) const { return posY_[index]; }
+    float getHeading(int index) const { return heading_[index]; }
+
+private:
+    std::shared_ptr<const CompiledTrack> track_;
+    std::unique_ptr<DistanceField> distanceField_;
+    float fieldResolution_;
+    size_t fieldMemoryLimit_;
+    int count_;
+    int running_;
+    float simulationTime_;
+    float finishDistance_;   // lap prefix that counts as complete (0 = full lap)
+    float sensorNoise_;
+    uint32_t noiseSeed_;
+
+    // Configuration
+    std::vector<float> kp_, ki_, kd_;
+    std::vector<float> maxSpeed_;
+    std::vector<float> wheelbase_;
+    std::vector<float> wheelMass_;
+    std::vector<float> stallForce_;
+    std::vector<float> traction_;
+    std::vector<float> sensorSpacing_;
+    std::vector<float> sensorHeight_;
+    std::vector<float> sensorRange_;
+    std::vector<int> sensorCount_;
+
+    // Robot state
+    std::vector<float> posX_, posY_, heading_;
+    std::vector<float> velocity_, angularVel_;
+    std::vector<float> leftWheelSpeed_, rightWheelSpeed_;
+    std::vector<float> leftMotor_, rightMotor_;
+    std::vector<float> power_;
+    std::vector<float> lineError_;
+    std::vector<float> sensorReadings_;  // count_ x MAX_SENSORS
+    std::vector<int> trackSegment_;
+    std::vector<uint32_t> noiseState_;
+
+    // PID controller state
+    std::vector<float> prevError_;
+    std::vector<float> errorIntegral_;
+
+    // Early-abort detection
+    FailureCriteria failureCriteria_;
+    std::vector<ProgressMonitor> monitors_;
+
+    // Outcome and accumulated metrics
+    std::vector<uint8_t> isComplete_;
+    std::vector<uint8_t> hasFailed_;
+    std::vector<float> completionTime_;
+    std::vector<float> elapsedTime_;
+    std::vector<float> trackError_;
+    std::vector<float> energy_;
+    std::vector<float> distance_;
+
+    /**
+     * @brief Read sensors and compute line error for running robots
+     */
+    void updateSensors();
+
+    /**
+     * @brief PID control and motor commands for all robots
+     */
+    void updateControl(float dt);
+
+    /**
+     * @brief Integrate drive dynamics for all robots in fixed substeps
+     */
+    void integrate(float dt);
+
+    /**
+     * @brief Accumulate metrics and check completion and failure
+     */
+    void updateOutcome(float dt);
+
+    /**
+     * @brief Check whether a robot is still running
+     */
+    bool isRunning(int index) const { return !isComplete_[index] && !hasFailed_[index]; }
+};
+
+} // namespace LineFollower
+
+#endif // SIMULATOR_BATCH_HPP
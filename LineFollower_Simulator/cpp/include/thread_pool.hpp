@@ -0,0 +1,111 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Work-stealing thread pool for parallel candidate evaluation
+ *
+ * A parallel-for over independent tasks whose cost varies widely (a
+ * simulation that aborts after 0.5 s next to one that runs the full lap).
+ * Each thread owns a deque of task indices seeded with a contiguous block;
+ * it pops from the back of its own deque and, once empty, steals from the
+ * front of the others, so long tasks do not leave cores idle.
+ *
+ * Under Emscripten the pool needs pthreads (-pthread); without them it has
+ * no workers and runs every task on the calling thread.
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LineFollower {
+
+/**
+ * @brief Fixed-size pool of worker threads
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Constructor
+     * @param threadCount Threads taking part in a parallelFor, including the
+     *                    caller (0 = one per hardware thread)
+     */
+    explicit ThreadPool(int threadCount = 0);
+
+    /**
+     * @brief Destructor - joins all workers
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Threads taking part in a parallelFor, including the caller
+     */
+    int size() const { return static_cast<int>(queues_.size()); }
+
+    /**
+     * @brief Run task(i) for every i in [0, count) and wait for all of them
+     *
+     * The calling thread works too. Tasks must be independent. Not reentrant:
+     * a task must not call parallelFor on the same pool. The first exception
+     * thrown by a task is rethrown here once every task has finished.
+     *
+     * @param count Number of tasks
+     * @param task Task body, called with the task index
+     */
+    void parallelFor(int count, const std::function<void(int)>& task);
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<int> items;
+    };
+
+    std::vector<std::thread> workers_;
+    std::vector<std::unique_ptr<WorkQueue>> queues_;  // [0] belongs to the caller
+
+    // Current job, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int)>* task_;
+    uint64_t generation_;
+    int remaining_;          // tasks not yet finished
+    int active_;             // workers currently inside the job
+    bool stopping_;
+    std::exception_ptr error_;
+
+    /**
+     * @brief Worker thread main loop
+     * @param self Index of the worker's own queue
+     */
+    void workerLoop(int self);
+
+    /**
+     * @brief Execute tasks until every queue is empty
+     * @param self Index of the calling thread's own queue
+     * @param task Task body
+     */
+    void drain(int self, const std::function<void(int)>& task);
+
+    /**
+     * @brief Take the next task: own queue first, then steal
+     * @param self Index of the calling thread's own queue
+     * @param item Output task index
+     * @return true if a task was taken
+     */
+    bool take(int self, int& item);
+};
+
+} // namespace LineFollower
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,135 @@
+/**
+ * @file track_index.hpp
+ * @brief Uniform-grid spatial index over track segments
+ *
+ * Answers nearest-segment and distance-to-line queries without scanning the
+ * whole polyline. The search visits grid rings outwards from the query cell
+ * and stops once no unvisited cell can be closer than the best segment, so
+ * sensor queries near the line touch only a handful of cells.
+ */
+
+#ifndef TRACK_INDEX_HPP
+#define TRACK_INDEX_HPP
+
+#include <vector>
+#include "simulator.hpp"
+
+namespace LineFollower {
+
+/**
+ * @brief Spatial index over the segments of a track polyline
+ */
+class TrackIndex {
+public:
+    /**
+     * @brief Constructor (empty index)
+     */
+    TrackIndex();
+
+    /**
+     * @brief Build index from track points
+     * @param trackPoints Track polyline
+     * @param cellSize Grid cell size in meters (0 chooses from mean segment length)
+     */
+    void build(const std::vector<TrackPoint>& trackPoints, float cellSize = 0.0f);
+
+    /**
+     * @brief Find nearest track segment to a point
+     * @param x Query x
+     * @param y Query y
+     * @param maxDistance Search radius; farther segments are ignored
+     * @param[out] segment Nearest segment index, or -1 if none within maxDistance
+     * @param[out] t Projection parameter on that segment in [0, 1]
+     * @return Distance to the nearest segment, or maxDistance if none closer
+     */
+    float nearest(float x, float y, float maxDistance, int& segment, float& t) const;
+
+    /**
+     * @brief Distance from a point to the track line
+     * @param x Query x
+     * @param y Query y
+     * @param maxDistance Search radius; result is capped at this value
+     * @return Distance in meters
+     */
+    float distance(float x, float y, float maxDistance) const;
+
+    /**
+     * @brief Advance a progress cursor to the nearest segment ahead of it
+     *
+     * Only segments at or after the cursor are considered, so closed loops
+     * cannot jump straight to their final segment.
+     *
+     * @param cursor Current segment
+     * @param x Robot x
+     * @param y Robot y
+     * @param window Number of segments searched ahead
+     * @return New cursor (never smaller than the input)
+     */
+    int advanceCursor(int cursor, float x, float y, int window) const;
+
+    /**
+     * @brief Arc length from the track start to a point on a segment
+     * @param segment Segment index
+     * @param t Position along the segment in [0, 1]
+     * @return Distance along the track (m)
+     */
+    float arcLength(int segment, float t) const {
+        return cumulativeLength_[segment] + t * (cumulativeLength_[segment + 1] - cumulativeLength_[segment]);
+    }
+
+    /**
+     * @brief Arc length at a track point (m)
+     */
+    float pointArcLength(int pointIndex) const { return cumulativeLength_[pointIndex]; }
+
+    /**
+     * @brief Project a pose onto a segment
+     * @param segment Segment index
+     * @param x Position x
+     * @param y Position y
+     * @param dirX Heading unit vector x
+     * @param dirY Heading unit vector y
+     * @param[out] arcLength Arc length of the projection (m)
+     * @param[out] alignment Cosine between heading and segment direction
+     */
+    void project(int segment, float x, float y, float dirX, float dirY, float& arcLength, float& alignment) const;
+
+    /**
+     * @brief Total track length (m)
+     */
+    float totalLength() const { return cumulativeLength_.empty() ? 0.0f : cumulativeLength_.back(); }
+
+    /**
+     * @brief Number of segments
+     */
+    int segmentCount() const { return static_cast<int>(points_.size()) - 1; }
+
+    /**
+     * @brief Track points the index was built from
+     */
+    const std::vector<TrackPoint>& points() const { return points_; }
+
+private:
+    std::vector<TrackPoint> points_;
+    std::vector<float> cumulativeLength_;  // arc length at each point
+
+    // Grid geometry
+    float originX_, originY_;
+    float cellSize_;
+    float invCellSize_;
+    int cellsX_, cellsY_;
+
+    // Compressed cell lists: segments of cell c are
+    // cellSegments_[cellStart_[c] .. cellStart_[c + 1])
+    std::vector<int> cellStart_;
+    std::vector<int> cellSegments_;
+
+    /**
+     * @brief Distance check against a run of consecutive segments
+     */
+    void scanSegments(float x, float y, int first, int last, float& bestSq, int& segment, float& t) const;
+};
+
+} // namespace LineFollower
+
+#endif // TRACK_INDEX_HPP
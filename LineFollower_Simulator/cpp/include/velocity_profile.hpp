@@ -0,0 +1,118 @@
+/**
+ * @file velocity_profile.hpp
+ * @brief Minimum-time speed profile along the track
+ *
+ * Classic forward-backward solution: cap the speed at every sample by the
+ * grip limit of the local curvature and the robot's top speed, sweep
+ * forward applying the acceleration limit, then backward applying the
+ * braking limit. Both passes are O(N) over the compiled track samples and
+ * the result is the fastest speed curve the limits allow, so its lap time
+ * is a lower bound for any controller and a target profile for planning.
+ */
+
+#ifndef VELOCITY_PROFILE_HPP
+#define VELOCITY_PROFILE_HPP
+
+#include <vector>
+#include "simulator.hpp"
+
+namespace LineFollower {
+
+class CompiledTrack;
+
+/**
+ * @brief Longitudinal and lateral limits of the robot
+ */
+struct VelocityLimits {
+    float maxSpeed;          // top speed (m/s)
+    float maxAcceleration;   // tractive acceleration from standstill (m/s²)
+    float maxDeceleration;   // braking deceleration (m/s²)
+    float friction;          // tire friction coefficient
+    float gravity;           // m/s²
+    bool motorLimited;       // acceleration falls linearly to zero at maxSpeed
+
+    /**
+     * @brief Limits implied by a robot configuration
+     *
+     * Grip from the temperature-adjusted friction; acceleration also capped
+     * by the motors' stall force, fading with speed along the DC motor
+     * torque-speed line.
+     */
+    static VelocityLimits fromConfig(const RobotConfig& config);
+};
+
+/**
+ * @brief Speed limit curve over uniformly spaced arc-length samples
+ */
+class VelocityProfile {
+public:
+    VelocityProfile();
+
+    /**
+     * @brief Solve over a compiled track, starting from rest
+     *
+     * Matches a simulated run: standstill at the first sample, free exit
+     * speed at the end, even on closed tracks.
+     *
+     * @param track Compiled track
+     * @param limits Robot limits
+     */
+    void compute(const CompiledTrack& track, const VelocityLimits& limits);
+
+    /**
+     * @brief Solve over a curvature array
+     * @param curvature Curvature per sample (1/m, sign ignored)
+     * @param spacing Arc length between samples (m)
+     * @param limits Robot limits
+     * @param entrySpeed Speed at the first sample (m/s); negative = free
+     * @param exitSpeed Speed at the last sample (m/s); negative = free
+     * @param periodic Treat the samples as a closed loop (last == first)
+     */
+    void compute(
+        const std::vector<float>& curvature,
+        float spacing,
+        const VelocityLimits& limits,
+        float entrySpeed,
+        float exitSpeed,
+        bool periodic
+    );
+
+    /**
+     * @brief Speed per sample (m/s)
+     */
+    const std::vector<float>& speed() const { return speed_; }
+
+    /**
+     * @brief Time to reach each sample from the first one (s)
+     */
+    const std::vector<float>& time() const { return time_; }
+
+    /**
+     * @brief Minimum time over the whole profile (s)
+     */
+    float lapTime() const { return time_.empty() ? 0.0f : time_.back(); }
+
+    /**
+     * @brief Profile speed at an arc length (linear interpolation)
+     */
+    float speedAt(float arcLength) const;
+
+    /**
+     * @brief Minimum time from an arc length to the end (s)
+     */
+    float remainingTime(float arcLength) const;
+
+private:
+    float spacing_;
+    std::vector<float> speed_;
+    std::vector<float> time_;
+
+    /**
+     * @brief Fractional sample position of an arc length
+     */
+    float position(float arcLength, int& sample) const;
+};
+
+} // namespace LineFollower
+
+#endif // VELOCITY_PROFILE_HPP
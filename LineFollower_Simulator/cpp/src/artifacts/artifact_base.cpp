@@ -0,0 +1,364 @@
+/**
+ * @file artifact_base.cpp
+ * @brief Shared artifact helpers: grip speed limit and racing line QP
+ */
+
+#include "../../include/artifacts/artifact_base.hpp"
+#include "../../include/physics.hpp"
+#include "../../include/velocity_profile.hpp"
+#include "../../include/thread_pool.hpp"
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace LineFollower {
+namespace Artifacts {
+
+namespace {
+
+// Curvature below this is treated as straight (1/m)
+constexpr float STRAIGHT_CURVATURE = 1e-4f;
+
+// Share of the sensor array half-span the racing line may use, leaving
+// outer sensors to catch the line on the way back
+constexpr float CORRIDOR_FRACTION = 0.5f;
+
+// Interior-point iterations before the current offsets are returned
+constexpr int MAX_IPM_ITERATIONS = 60;
+
+// Centring parameter: each Newton step targets this share of the current
+// complementarity gap
+constexpr double CENTERING = 0.1;
+
+// Fraction of the step to the bound boundary taken
+constexpr double STEP_TO_BOUNDARY = 0.995;
+
+// Convergence: complementarity gap and stationarity, relative to the start
+constexpr double IPM_TOLERANCE = 1e-9;
+
+// Weight on squared offset against squared curvature (1/m^4): offsets
+// relax back onto the line over roughly WEIGHT^(-1/4) = 0.2 m, so straights
+// are driven on the line and the QP stays well conditioned
+constexpr double CENTRELINE_WEIGHT = 625.0;
+
+// Shortest segment used when weighting the curvature stencil (m)
+constexpr double MIN_SEGMENT = 1e-6;
+
+// Arc-length spacing of the grid the QP is solved on (m). At the point
+// spacing of dense tracks, float coordinates divided by ds^2 would swamp
+// the curvature; matches CompiledTrack's curvature stencil.
+constexpr double RACING_LINE_SPACING = 0.02;
+
+/**
+ * @brief Largest step in [0, 1] keeping v + step * dv positive
+ */
+double stepToBoundary(const Eigen::VectorXd& v, const Eigen::VectorXd& dv) {
+    double step = 1.0;
+    for (int j = 0; j < v.size(); j++) {
+        if (dv[j] < 0.0) {
+            step = std::min(step, -STEP_TO_BOUNDARY * v[j] / dv[j]);
+        }
+    }
+    return step;
+}
+
+/**
+ * @brief Unit normals of a polyline, from central differences
+ */
+std::vector<Eigen::Vector2d> polylineNormals(const std::vector<Eigen::Vector2d>& p) {
+    int m = static_cast<int>(p.size());
+    std::vector<Eigen::Vector2d> normal(m);
+    for (int j = 0; j < m; j++) {
+        Eigen::Vector2d tangent = p[std::min(j + 1, m - 1)] - p[std::max(j - 1, 0)];
+        double length = tangent.norm();
+        tangent = length > 0.0 ? Eigen::Vector2d(tangent / length) : Eigen::Vector2d(1.0, 0.0);
+        normal[j] = Eigen::Vector2d(-tangent.y(), tangent.x());
+    }
+    return normal;
+}
+
+/**
+ * @brief Minimum-curvature offsets of a polyline within +-w
+ *
+ * Discrete curvature at point i is linear in the offsets:
+ *   k_i = a r_{i-1} + b r_i + c r_{i+1},  r_j = p_j + alpha_j n_j
+ * with the non-uniform second-difference weights, so sum(ds_i |k_i|^2)
+ * is a quadratic with a banded Hessian (bandwidth 2). The centreline
+ * weight adds a diagonal term and keeps the Hessian positive definite.
+ *
+ * The box constraints are handled by a primal-dual interior point method:
+ * every Newton step is one LDLT of the Hessian plus a diagonal, on a
+ * pattern analysed once, and the iteration count does not grow with the
+ * number of offsets at the corridor edge.
+ *
+ * @return One offset per point; the two ends stay at 0
+ */
+Eigen::VectorXd minimumCurvatureOffsets(
+    const std::vector<Eigen::Vector2d>& p,
+    const std::vector<Eigen::Vector2d>& normal,
+    double w)
+{
+    int m = static_cast<int>(p.size());
+
+    // Ends are pinned to the line, so the unknowns are the m - 2 interior
+    // offsets; variable v is point v + 1. Objective 0.5 x'Hx + g'x.
+    int n = m - 2;
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(9 * m);
+    Eigen::VectorXd g = Eigen::VectorXd::Zero(n);
+    for (int i = 1; i + 1 < m; i++) {
+        double before = std::max((p[i] - p[i - 1]).norm(), MIN_SEGMENT);
+        double after = std::max((p[i + 1] - p[i]).norm(), MIN_SEGMENT);
+        double ds = 0.5 * (before + after);
+        double a = 1.0 / (ds * before);
+        double c = 1.0 / (ds * after);
+        int index[3] = {i - 1, i, i + 1};
+        double coef[3] = {a, -(a + c), c};
+
+        Eigen::Vector2d residual = a * p[i - 1] + coef[1] * p[i] + c * p[i + 1];
+        for (int u = 0; u < 3; u++) {
+            int row = index[u] - 1;
+            if (row < 0 || row >= n) {
+                continue;
+            }
+            g[row] += ds * coef[u] * normal[index[u]].dot(residual);
+            for (int v = 0; v < 3; v++) {
+                int col = index[v] - 1;
+                if (col >= 0 && col < n) {
+                    triplets.emplace_back(row, col, ds * coef[u] * coef[v] * normal[index[u]].dot(normal[index[v]]));
+                }
+            }
+        }
+        triplets.emplace_back(i - 1, i - 1, CENTRELINE_WEIGHT * ds);
+    }
+    Eigen::SparseMatrix<double> H(n, n);
+    H.setFromTriplets(triplets.begin(), triplets.end());
+
+    // Start at the centreline, strictly inside the corridor
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+    double scale = std::max(g.cwiseAbs().maxCoeff(), 1.0);
+    Eigen::VectorXd zUpper = Eigen::VectorXd::Constant(n, scale);
+    Eigen::VectorXd zLower = Eigen::VectorXd::Constant(n, scale);
+    double initialGap = scale * w;
+
+    Eigen::SparseMatrix<double> K = H;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
+    solver.analyzePattern(K);
+
+    for (int iter = 0; iter < MAX_IPM_ITERATIONS; iter++) {
+        Eigen::VectorXd sUpper = (w - x.array()).matrix();
+        Eigen::VectorXd sLower = (x.array() + w).matrix();
+        Eigen::VectorXd dual = H * x + g + zUpper - zLower;
+        double gap = (zUpper.dot(sUpper) + zLower.dot(sLower)) / (2.0 * n);
+        if (gap < IPM_TOLERANCE * initialGap && dual.cwiseAbs().maxCoeff() < IPM_TOLERANCE * scale) {
+            break;
+        }
+
+        // Newton step on the perturbed KKT system, bound multipliers
+        // eliminated: (H + Zu/Su + Zl/Sl) dx = rhs
+        double target = CENTERING * gap;
+        Eigen::VectorXd rhs = -dual
+            - (target / sUpper.array() - zUpper.array()).matrix()
+            + (target / sLower.array() - zLower.array()).matrix();
+        K = H;
+        for (int j = 0; j < n; j++) {
+            K.coeffRef(j, j) += zUpper[j] / sUpper[j] + zLower[j] / sLower[j];
+        }
+        solver.factorize(K);
+        if (solver.info() != Eigen::Success) {
+            break;
+        }
+        Eigen::VectorXd dx = solver.solve(rhs);
+        Eigen::VectorXd dzUpper = ((target - zUpper.array() * sUpper.array() + zUpper.array() * dx.array()) / sUpper.array()).matrix();
+        Eigen::VectorXd dzLower = ((target - zLower.array() * sLower.array() - zLower.array() * dx.array()) / sLower.array()).matrix();
+
+        double step = std::min({
+            stepToBoundary(sUpper, -dx),
+            stepToBoundary(sLower, dx),
+            stepToBoundary(zUpper, dzUpper),
+            stepToBoundary(zLower, dzLower)
+        });
+        x += step * dx;
+        zUpper += step * dzUpper;
+        zLower += step * dzLower;
+    }
+
+    Eigen::VectorXd offsets = Eigen::VectorXd::Zero(m);
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] = Physics::clamp(x[v], -w, w);
+    }
+    return offsets;
+}
+
+/**
+ * @brief Minimum-curvature racing line for one span of the line
+ *
+ * The QP is solved on a uniform arc-length grid of RACING_LINE_SPACING
+ * (or the mean point spacing, if coarser), resampled from the points in
+ * double precision, and its offsets are interpolated back to every point.
+ */
+std::vector<TrackPoint> solveRacingLine(
+    const std::vector<TrackPoint>& trackPoints,
+    int startIndex,
+    int endIndex,
+    float halfWidth)
+{
+    int last = static_cast<int>(trackPoints.size()) - 1;
+    startIndex = std::max(startIndex, 0);
+    endIndex = std::min(endIndex, last);
+    if (endIndex < startIndex) {
+        return {};
+    }
+    std::vector<TrackPoint> line(trackPoints.begin() + startIndex, trackPoints.begin() + endIndex + 1);
+    if (endIndex - startIndex < 2 || halfWidth <= 0.0f) {
+        return line;
+    }
+
+    int m = endIndex - startIndex + 1;
+    std::vector<Eigen::Vector2d> p(m);
+    std::vector<double> arc(m, 0.0);
+    for (int j = 0; j < m; j++) {
+        p[j] = Eigen::Vector2d(line[j].x, line[j].y);
+        if (j > 0) {
+            arc[j] = arc[j - 1] + (p[j] - p[j - 1]).norm();
+        }
+    }
+    double length = arc.back();
+    if (length <= 0.0) {
+        return line;
+    }
+
+    // Uniform grid, no finer than the points themselves
+    double spacing = std::max(RACING_LINE_SPACING, length / (m - 1));
+    int nodes = std::max(3, static_cast<int>(std::round(length / spacing)) + 1);
+    spacing = length / (nodes - 1);
+    std::vector<Eigen::Vector2d> grid(nodes);
+    int segment = 0;
+    for (int k = 0; k < nodes; k++) {
+        double s = k * spacing;
+        while (segment < m - 2 && arc[segment + 1] < s) {
+            segment++;
+        }
+        double span = arc[segment + 1] - arc[segment];
+        double t = span > 0.0 ? Physics::clamp((s - arc[segment]) / span, 0.0, 1.0) : 0.0;
+        grid[k] = p[segment] + t * (p[segment + 1] - p[segment]);
+    }
+
+    Eigen::VectorXd offsets = minimumCurvatureOffsets(grid, polylineNormals(grid), halfWidth);
+
+    // Back onto the points, along their own normals; ends stay pinned
+    std::vector<Eigen::Vector2d> normal = polylineNormals(p);
+    for (int j = 1; j + 1 < m; j++) {
+        double u = arc[j] / spacing;
+        int k = std::min(static_cast<int>(u), nodes - 2);
+        double t = u - k;
+        double offset = (1.0 - t) * offsets[k] + t * offsets[k + 1];
+        Eigen::Vector2d r = p[j] + offset * normal[j];
+        line[j].x = static_cast<float>(r.x());
+        line[j].y = static_cast<float>(r.y());
+    }
+    return line;
+}
+
+} // namespace
+
+std::vector<std::vector<TrackPoint>> ArtifactBase::calculateRacingLines(
+    const std::vector<Artifact>& artifacts,
+    const std::vector<TrackPoint>& trackPoints,
+    float halfWidth,
+    ThreadPool& pool)
+{
+    std::vector<std::vector<TrackPoint>> lines(artifacts.size());
+    pool.parallelFor(static_cast<int>(artifacts.size()), [&](int i) {
+        lines[i] = solveRacingLine(trackPoints, artifacts[i].startIndex, artifacts[i].endIndex, halfWidth);
+    });
+    return lines;
+}
+
+float ArtifactBase::corridorHalfWidth(const RobotConfig& config) {
+    float halfSpan = 0.5f * static_cast<float>(std::max(config.sensorCount - 1, 0)) * config.sensorSpacing;
+    return CORRIDOR_FRACTION * halfSpan;
+}
+
+float ArtifactBase::calculateMaxSafeSpeed(float curvature, const RobotConfig& config) const {
+    float k = std::abs(curvature);
+    if (k < STRAIGHT_CURVATURE) {
+        return config.maxSpeed;
+    }
+    float friction = Physics::adjustFrictionForTemperature(config.frictionCoeff, config.temperature);
+    float grip = Physics::optimalCurveSpeed(1.0f / k, friction, config.gravity);
+
+    // Outer wheel runs at v (1 + wheelbase k / 2) and tops out at maxSpeed
+    float wheel = config.maxSpeed / (1.0f + 0.5f * config.wheelbase * k);
+    return std::min(grip, wheel);
+}
+
+void ArtifactBase::traverse(
+    float length,
+    float entrySpeed,
+    float cruiseSpeed,
+    float exitSpeed,
+    const RobotConfig& config,
+    ArtifactStrategy& strategy) const
+{
+    VelocityLimits limits = VelocityLimits::fromConfig(config);
+    float a = limits.maxAcceleration;
+    float d = limits.maxDeceleration;
+    length = std::max(length, 0.0f);
+
+    float exitCap = std::min(exitSpeed, cruiseSpeed);
+    float v0 = std::min({entrySpeed, cruiseSpeed, std::sqrt(exitCap * exitCap + 2.0f * d * length)});
+    float ve = std::min(exitCap, std::sqrt(v0 * v0 + 2.0f * a * length));
+
+    // Peak where the acceleration and braking parabolas meet, or cruise
+    float peak = std::sqrt((2.0f * a * d * length + d * v0 * v0 + a * ve * ve) / (a + d));
+    peak = Physics::clamp(peak, std::max(v0, ve), std::max(cruiseSpeed, std::max(v0, ve)));
+
+    float accelerating = (peak * peak - v0 * v0) / (2.0f * a);
+    float braking = Physics::brakingDistance(peak, ve, d);
+    float cruising = std::max(0.0f, length - accelerating - braking);
+
+    float time = (peak - v0) / a + (peak - ve) / d;
+    if (peak > 0.0f) {
+        time += cruising / peak;
+    }
+
+    strategy.entrySpeed = v0;
+    strategy.exitSpeed = ve;
+    strategy.maxSpeed = peak;
+    strategy.estimatedTime = time;
+    strategy.averageSpeed = time > 0.0f ? length / time : peak;
+}
+
+float ArtifactBase::effectiveRadius(float radius, float turnAngle, float halfWidth) {
+    if (radius <= 0.0f || halfWidth <= 0.0f) {
+        return radius;
+    }
+    if (turnAngle >= Physics::PI) {
+        // Turning past a semicircle: ride the outside, concentric
+        return radius + halfWidth;
+    }
+
+    // Circle through the outer edge at entry and exit and the inner edge
+    // at the apex; its centre moves out along the bisector
+    float c = std::cos(0.5f * turnAngle);
+    float denominator = radius * (1.0f - c) - halfWidth * (1.0f + c);
+    if (denominator <= 0.0f) {
+        // Corridor wider than the curve's sagitta: nearly straight through
+        return std::numeric_limits<float>::max();
+    }
+    return radius - halfWidth + 2.0f * radius * halfWidth / denominator;
+}
+
+std::vector<TrackPoint> ArtifactBase::calculateRacingLine(
+    const std::vector<TrackPoint>& trackPoints,
+    int startIndex,
+    int endIndex,
+    float halfWidth) const
+{
+    return solveRacingLine(trackPoints, startIndex, endIndex, halfWidth);
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
@@ -0,0 +1,77 @@
+/**
+ * @file artifact_factory.cpp
+ * @brief Implementation of the artifact factory and track estimate
+ */
+
+#include "../../include/artifacts/artifact_factory.hpp"
+#include "../../include/artifacts/straight.hpp"
+#include "../../include/artifacts/circular_curve.hpp"
+#include "../../include/artifacts/s_curve.hpp"
+#include "../../include/artifacts/chicane.hpp"
+#include "../../include/artifacts/hairpin.hpp"
+#include "../../include/artifacts/spiral.hpp"
+#include "../../include/artifacts/complex.hpp"
+#include <limits>
+
+namespace LineFollower {
+namespace Artifacts {
+
+std::unique_ptr<ArtifactBase> createArtifact(const Artifact& artifact) {
+    switch (artifact.type) {
+        case ArtifactType::STRAIGHT:
+            return std::make_unique<Straight>(artifact);
+        case ArtifactType::CIRCULAR_CURVE:
+        case ArtifactType::TRANSITION:
+            return std::make_unique<CircularCurve>(artifact);
+        case ArtifactType::S_CURVE:
+            return std::make_unique<SCurve>(artifact);
+        case ArtifactType::CHICANE:
+            return std::make_unique<Chicane>(artifact);
+        case ArtifactType::HAIRPIN:
+            return std::make_unique<Hairpin>(artifact);
+        case ArtifactType::SPIRAL:
+            return std::make_unique<Spiral>(artifact);
+        case ArtifactType::UNKNOWN:
+        case ArtifactType::COMPLEX:
+        default:
+            return std::make_unique<Complex>(artifact);
+    }
+}
+
+TrackEstimate estimateTrack(
+    const std::vector<Artifact>& artifacts,
+    const RobotConfig& config,
+    const std::vector<TrackPoint>& trackPoints)
+{
+    const float unbounded = std::numeric_limits<float>::max();
+
+    std::vector<std::unique_ptr<ArtifactBase>> library;
+    library.reserve(artifacts.size());
+    for (const Artifact& artifact : artifacts) {
+        library.push_back(createArtifact(artifact));
+    }
+
+    // Backward: fastest admissible entry of each artifact caps the exit of
+    // the one before (free exit at the finish)
+    float exitLimit = unbounded;
+    for (size_t i = library.size(); i-- > 0;) {
+        library[i]->setExitLimit(exitLimit);
+        exitLimit = library[i]->calculateOptimalStrategy(config, trackPoints, unbounded).entrySpeed;
+    }
+
+    // Forward: from standstill through every artifact
+    TrackEstimate estimate;
+    estimate.totalTime = 0.0f;
+    estimate.strategies.reserve(library.size());
+    float speed = 0.0f;
+    for (auto& artifact : library) {
+        ArtifactStrategy strategy = artifact->calculateOptimalStrategy(config, trackPoints, speed);
+        speed = strategy.exitSpeed;
+        estimate.totalTime += strategy.estimatedTime;
+        estimate.strategies.push_back(strategy);
+    }
+    return estimate;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
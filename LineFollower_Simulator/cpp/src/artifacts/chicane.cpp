@@ -0,0 +1,49 @@
+/**
+ * @file chicane.cpp
+ * @brief Implementation of the chicane strategy
+ */
+
+#include "../../include/artifacts/chicane.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+ArtifactStrategy Chicane::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    // Short alternating lobes: if each lobe's sagitta fits in the
+    // corridor the line runs straight through, otherwise every lobe is
+    // taken on its widest arc at the tightest lobe's speed
+    float halfWidth = corridorHalfWidth(robotConfig);
+    float tightest = artifact_.peakCurvature > 0.0f ? 1.0f / artifact_.peakCurvature : 0.0f;
+    float lobeAngle = artifact_.turnAngle / std::max(artifact_.lobes, 1);
+    float sagitta = tightest * (1.0f - std::cos(0.5f * lobeAngle));
+
+    float speed = robotConfig.maxSpeed;
+    bool straightened = sagitta <= halfWidth;
+    if (!straightened) {
+        float radius = effectiveRadius(tightest, lobeAngle, halfWidth);
+        speed = calculateMaxSafeSpeed(radius > 0.0f ? 1.0f / radius : 0.0f, robotConfig);
+    }
+
+    ArtifactStrategy strategy;
+    traverse(artifact_.length, prevExitSpeed, speed, exitLimit_, robotConfig, strategy);
+
+    char text[128];
+    if (straightened) {
+        std::snprintf(text, sizeof(text), "Chicane of %d curves: straight-lined at %.2f m/s", artifact_.lobes, speed);
+    } else {
+        std::snprintf(text, sizeof(text), "Chicane of %d curves: smooth line at %.2f m/s (tightest R=%.2f m)",
+            artifact_.lobes, speed, tightest);
+    }
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
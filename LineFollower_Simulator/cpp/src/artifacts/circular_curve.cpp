@@ -0,0 +1,33 @@
+/**
+ * @file circular_curve.cpp
+ * @brief Implementation of the circular curve strategy
+ */
+
+#include "../../include/artifacts/circular_curve.hpp"
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+ArtifactStrategy CircularCurve::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    // Enter wide, clip the apex, exit wide: v = sqrt(mu g R) on the
+    // widest arc the corridor allows
+    float radius = effectiveRadius(artifact_.radius, artifact_.turnAngle, corridorHalfWidth(robotConfig));
+    float cornerSpeed = calculateMaxSafeSpeed(radius > 0.0f ? 1.0f / radius : 0.0f, robotConfig);
+
+    ArtifactStrategy strategy;
+    traverse(artifact_.length, prevExitSpeed, cornerSpeed, exitLimit_, robotConfig, strategy);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "In this %.2f m radius curve, limited by grip to %.2f m/s (racing line R=%.2f m)",
+        artifact_.radius, cornerSpeed, radius);
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
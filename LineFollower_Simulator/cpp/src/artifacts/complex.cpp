@@ -0,0 +1,87 @@
+/**
+ * @file complex.cpp
+ * @brief Implementation of the complex artifact strategy
+ */
+
+#include "../../include/artifacts/complex.hpp"
+#include "../../include/compiled_track.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+namespace LineFollower {
+namespace Artifacts {
+
+namespace {
+
+/**
+ * @brief Whether two configurations give the solver the same problem
+ */
+bool sameDynamics(const RobotConfig& a, const RobotConfig& b) {
+    return a.mass == b.mass && a.wheelbase == b.wheelbase && a.wheelDiameter == b.wheelDiameter &&
+        a.maxSpeed == b.maxSpeed && a.temperature == b.temperature &&
+        a.frictionCoeff == b.frictionCoeff && a.gravity == b.gravity;
+}
+
+} // namespace
+
+ArtifactStrategy Complex::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& trackPoints,
+    float prevExitSpeed)
+{
+    // Curvature along this artifact only, compiled on first use
+    int last = static_cast<int>(trackPoints.size()) - 1;
+    int start = std::max(artifact_.startIndex, 0);
+    int end = std::min(artifact_.endIndex, last);
+    if (curvature_.empty() && end - start >= 1) {
+        std::vector<TrackPoint> span(trackPoints.begin() + start, trackPoints.begin() + end + 1);
+        CompiledTrack track(span);
+        curvature_ = track.curvature();
+        spacing_ = track.spacing();
+    }
+
+    // A free-entry solve enters as fast as the segment allows, so any cap
+    // at or above that speed leaves the optimum unchanged: estimateTrack's
+    // forward pass then reuses the backward pass's solution
+    const float unbounded = std::numeric_limits<float>::max();
+    bool reusable = solved_ && !solution_.speed.empty() && solvedExit_ == exitLimit_ &&
+        sameDynamics(solvedConfig_, robotConfig) &&
+        (prevExitSpeed == solvedEntry_ ||
+         (solvedEntry_ >= unbounded && prevExitSpeed >= solution_.speed.front()));
+    if (!reusable) {
+        // Unbounded speeds mean free ends for the solver
+        float entry = prevExitSpeed >= unbounded ? -1.0f : prevExitSpeed;
+        float exit = exitLimit_ >= unbounded ? -1.0f : exitLimit_;
+
+        Optimizers::DirectCollocation solver;
+        solution_ = solver.solve(curvature_, spacing_, robotConfig, entry, exit);
+        solved_ = true;
+        solvedEntry_ = prevExitSpeed;
+        solvedExit_ = exitLimit_;
+        solvedConfig_ = robotConfig;
+    }
+    const Optimizers::CollocationResult& solution = solution_;
+
+    ArtifactStrategy strategy;
+    char text[128];
+    if (!solution.speed.empty()) {
+        strategy.entrySpeed = solution.speed.front();
+        strategy.exitSpeed = solution.speed.back();
+        strategy.maxSpeed = *std::max_element(solution.speed.begin(), solution.speed.end());
+        strategy.estimatedTime = solution.time;
+        strategy.averageSpeed = solution.time > 0.0f ? artifact_.length / solution.time : strategy.maxSpeed;
+        std::snprintf(text, sizeof(text), "Complex section %.2f m: minimum-time profile, %.2f to %.2f m/s",
+            artifact_.length, *std::min_element(solution.speed.begin(), solution.speed.end()), strategy.maxSpeed);
+    } else {
+        // Degenerate span: hold the tightest point's grip speed throughout
+        float speed = calculateMaxSafeSpeed(artifact_.peakCurvature, robotConfig);
+        traverse(artifact_.length, prevExitSpeed, speed, exitLimit_, robotConfig, strategy);
+        std::snprintf(text, sizeof(text), "Complex section %.2f m: conservative %.2f m/s", artifact_.length, speed);
+    }
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
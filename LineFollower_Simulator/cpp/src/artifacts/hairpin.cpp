@@ -0,0 +1,33 @@
+/**
+ * @file hairpin.cpp
+ * @brief Implementation of the hairpin strategy
+ */
+
+#include "../../include/artifacts/hairpin.hpp"
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+ArtifactStrategy Hairpin::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    // Wide entry and late apex gain about one corridor half-width of
+    // radius; the apex speed is also bounded by the outer wheel
+    float radius = effectiveRadius(artifact_.radius, artifact_.turnAngle, corridorHalfWidth(robotConfig));
+    float apexSpeed = calculateMaxSafeSpeed(radius > 0.0f ? 1.0f / radius : 0.0f, robotConfig);
+
+    ArtifactStrategy strategy;
+    traverse(artifact_.length, prevExitSpeed, apexSpeed, exitLimit_, robotConfig, strategy);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "Hairpin R=%.2f m: brake to %.2f m/s, wide entry, late apex, accelerate on exit",
+        artifact_.radius, apexSpeed);
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
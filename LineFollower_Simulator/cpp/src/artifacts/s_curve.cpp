@@ -0,0 +1,36 @@
+/**
+ * @file s_curve.cpp
+ * @brief Implementation of the S-curve strategy
+ */
+
+#include "../../include/artifacts/s_curve.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+ArtifactStrategy SCurve::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    // One speed through both lobes so grip is never exceeded at the
+    // direction change; the tighter lobe sets it
+    float tightest = artifact_.peakCurvature > 0.0f ? 1.0f / artifact_.peakCurvature : 0.0f;
+    float lobeAngle = 0.5f * artifact_.turnAngle;
+    float radius = effectiveRadius(tightest, lobeAngle, corridorHalfWidth(robotConfig));
+    float speed = calculateMaxSafeSpeed(radius > 0.0f ? 1.0f / radius : 0.0f, robotConfig);
+
+    ArtifactStrategy strategy;
+    traverse(artifact_.length, prevExitSpeed, speed, exitLimit_, robotConfig, strategy);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "S-curve: hold %.2f m/s through the direction change (tightest R=%.2f m)",
+        speed, tightest);
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
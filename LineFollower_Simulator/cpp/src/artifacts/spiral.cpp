@@ -0,0 +1,57 @@
+/**
+ * @file spiral.cpp
+ * @brief Implementation of the spiral strategy
+ */
+
+#include "../../include/artifacts/spiral.hpp"
+#include <algorithm>
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+namespace {
+
+// Simpson intervals for the grip-limited traversal time
+constexpr int INTEGRATION_INTERVALS = 16;
+
+} // namespace
+
+ArtifactStrategy Spiral::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    // Curvature taken as linear from entry to exit (clothoid); integrate
+    // ds / v(k(s)) along the grip limit
+    float entryCurvature = artifact_.entryCurvature;
+    float exitCurvature = artifact_.exitCurvature;
+    float length = artifact_.length;
+
+    float gripTime = 0.0f;
+    float h = length / INTEGRATION_INTERVALS;
+    for (int i = 0; i <= INTEGRATION_INTERVALS; i++) {
+        float t = static_cast<float>(i) / INTEGRATION_INTERVALS;
+        float speed = calculateMaxSafeSpeed(entryCurvature + (exitCurvature - entryCurvature) * t, robotConfig);
+        float weight = (i == 0 || i == INTEGRATION_INTERVALS) ? 1.0f : (i % 2 == 1 ? 4.0f : 2.0f);
+        gripTime += weight / std::max(speed, 1e-3f);
+    }
+    gripTime *= h / 3.0f;
+
+    // Harmonic-mean speed along the limit stands in for the cruise phase;
+    // the ends keep their own grip limits
+    float meanSpeed = gripTime > 0.0f ? length / gripTime : robotConfig.maxSpeed;
+    float entrySpeed = calculateMaxSafeSpeed(entryCurvature, robotConfig);
+    float exitSpeed = calculateMaxSafeSpeed(exitCurvature, robotConfig);
+
+    ArtifactStrategy strategy;
+    traverse(length, std::min(prevExitSpeed, entrySpeed), meanSpeed, std::min(exitLimit_, exitSpeed), robotConfig, strategy);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "Spiral: speed follows grip from %.2f to %.2f m/s", entrySpeed, exitSpeed);
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
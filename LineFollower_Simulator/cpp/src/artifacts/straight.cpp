@@ -0,0 +1,33 @@
+/**
+ * @file straight.cpp
+ * @brief Implementation of the straight strategy
+ */
+
+#include "../../include/artifacts/straight.hpp"
+#include "../../include/physics.hpp"
+#include "../../include/velocity_profile.hpp"
+#include <cstdio>
+
+namespace LineFollower {
+namespace Artifacts {
+
+ArtifactStrategy Straight::calculateOptimalStrategy(
+    const RobotConfig& robotConfig,
+    const std::vector<TrackPoint>& /*trackPoints*/,
+    float prevExitSpeed)
+{
+    ArtifactStrategy strategy;
+    traverse(artifact_.length, prevExitSpeed, robotConfig.maxSpeed, exitLimit_, robotConfig, strategy);
+
+    float deceleration = VelocityLimits::fromConfig(robotConfig).maxDeceleration;
+    float braking = Physics::brakingDistance(strategy.maxSpeed, strategy.exitSpeed, deceleration);
+
+    char text[128];
+    std::snprintf(text, sizeof(text), "Straight %.2f m: full throttle to %.2f m/s, brake %.2f m before exit",
+        artifact_.length, strategy.maxSpeed, braking);
+    strategy.description = text;
+    return strategy;
+}
+
+} // namespace Artifacts
+} // namespace LineFollower
@@ -10,12 +10,64 @@
 #include <emscripten/val.h>
 #include "../include/simulator.hpp"
 #include "../include/optimizer.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/velocity_profile.hpp"
+#include "../include/optimizers/mpc.hpp"
 #include "../include/pattern_recognizer.hpp"
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace emscripten;
 using namespace LineFollower;
 
+namespace {
+
+// Frames runUntilDone keeps at most; longer runs are decimated further
+constexpr size_t MAX_RUN_FRAMES = 1 << 18;
+
+/**
+ * @brief Robot configuration from its JavaScript object
+ */
+RobotConfig parseConfig(val configObj) {
+    RobotConfig config;
+    config.mass = configObj["mass"].as<float>();
+    config.wheelbase = configObj["wheelbase"].as<float>();
+    config.wheelDiameter = configObj["wheelDiameter"].as<float>();
+    config.maxSpeed = configObj["maxSpeed"].as<float>();
+    config.sensorCount = configObj["sensors"]["count"].as<int>();
+    config.sensorSpacing = configObj["sensors"]["spacing"].as<float>();
+    config.sensorHeight = configObj["sensors"]["height"].as<float>();
+    config.kp = configObj["pid"]["kp"].as<float>();
+    config.ki = configObj["pid"]["ki"].as<float>();
+    config.kd = configObj["pid"]["kd"].as<float>();
+    config.temperature = configObj["environment"]["temperature"].as<float>();
+    config.frictionCoeff = configObj["environment"]["friction"].as<float>();
+    config.gravity = configObj["environment"]["gravity"].as<float>();
+    return config;
+}
+
+/**
+ * @brief Track polyline from a JavaScript track object
+ */
+std::vector<TrackPoint> parseTrack(val trackObj) {
+    std::vector<TrackPoint> trackPoints;
+    val pointsArray = trackObj["points"];
+    int numPoints = pointsArray["length"].as<int>();
+
+    for (int i = 0; i < numPoints; i++) {
+        val point = pointsArray[i];
+        TrackPoint tp;
+        tp.x = point["x"].as<float>();
+        tp.y = point["y"].as<float>();
+        trackPoints.push_back(tp);
+    }
+    return trackPoints;
+}
+
+} // namespace
+
 /**
  * @brief JavaScript-friendly wrapper for simulator
  */
@@ -27,34 +79,8 @@ public:
      * @brief Initialize simulator with configuration
      */
     bool initialize(val configObj, val trackObj) {
-        // Parse robot configuration from JavaScript object
-        RobotConfig config;
-        config.mass = configObj["mass"].as<float>();
-        config.wheelbase = configObj["wheelbase"].as<float>();
-        config.wheelDiameter = configObj["wheelDiameter"].as<float>();
-        config.maxSpeed = configObj["maxSpeed"].as<float>();
-        config.sensorCount = configObj["sensors"]["count"].as<int>();
-        config.sensorSpacing = configObj["sensors"]["spacing"].as<float>();
-        config.sensorHeight = configObj["sensors"]["height"].as<float>();
-        config.kp = configObj["pid"]["kp"].as<float>();
-        config.ki = configObj["pid"]["ki"].as<float>();
-        config.kd = configObj["pid"]["kd"].as<float>();
-        config.temperature = configObj["environment"]["temperature"].as<float>();
-        config.frictionCoeff = configObj["environment"]["friction"].as<float>();
-        config.gravity = configObj["environment"]["gravity"].as<float>();
-
-        // Parse track points from JavaScript array
-        std::vector<TrackPoint> trackPoints;
-        val pointsArray = trackObj["points"];
-        int numPoints = pointsArray["length"].as<int>();
-
-        for (int i = 0; i < numPoints; i++) {
-            val point = pointsArray[i];
-            TrackPoint tp;
-            tp.x = point["x"].as<float>();
-            tp.y = point["y"].as<float>();
-            trackPoints.push_back(tp);
-        }
+        RobotConfig config = parseConfig(configObj);
+        std::vector<TrackPoint> trackPoints = parseTrack(trackObj);
 
         // Create simulator
         simulator_ = std::make_unique<Simulator>(config, trackPoints);
@@ -70,6 +96,81 @@ public:
         }
     }
 
+    /**
+     * @brief Run to completion inside C++ and return decimated frames
+     *
+     * Frames are returned as a Float32Array view into WASM memory
+     * (FRAME_STRIDE floats per frame). The view is only valid until the next
+     * call; copy it if it must be kept. Runs that would exceed MAX_RUN_FRAMES
+     * frames are recorded with a coarser decimation.
+     */
+    val runUntilDone(float dt, float maxTime, int decimation) {
+        val result = val::object();
+        if (!simulator_ || !(dt > 0.0f) || !std::isfinite(dt) || !std::isfinite(maxTime)) {
+            return result;
+        }
+
+        double remaining = std::max(static_cast<double>(maxTime) - simulator_->getCurrentState().time, 0.0);
+        double steps = std::ceil(remaining / dt);
+        double minDecimation = std::ceil(steps / static_cast<double>(MAX_RUN_FRAMES - 2));
+        if (minDecimation > decimation) {
+            decimation = static_cast<int>(std::min(minDecimation, static_cast<double>(std::numeric_limits<int>::max())));
+        }
+        decimation = std::max(decimation, 1);
+        size_t capacity = static_cast<size_t>(std::min(std::ceil(steps / decimation) + 2.0, static_cast<double>(MAX_RUN_FRAMES)));
+        if (frameBuffer_.size() < capacity * FRAME_STRIDE) {
+            frameBuffer_.resize(capacity * FRAME_STRIDE);
+        }
+
+        int frameCount = simulator_->run(dt, maxTime, decimation, frameBuffer_.data(), static_cast<int>(capacity));
+
+        result.set("frames", val(typed_memory_view(frameCount * FRAME_STRIDE, frameBuffer_.data())));
+        result.set("frameCount", frameCount);
+        result.set("stride", FRAME_STRIDE);
+        result.set("complete", simulator_->isComplete());
+        result.set("failed", simulator_->hasFailed());
+        result.set("completionTime", simulator_->getCompletionTime());
+        result.set("mpcFallbacks", simulator_->getMPCFallbacks());
+        return result;
+    }
+
+    /**
+     * @brief Switch between the PID and the model predictive controller
+     * @param enabled true to drive with the MPC (default settings)
+     */
+    void setMPC(bool enabled) {
+        if (!simulator_) {
+            return;
+        }
+        if (enabled) {
+            simulator_->enableMPC(Optimizers::MPCSettings::defaults());
+        } else {
+            simulator_->disableMPC();
+        }
+        simulator_->reset();
+    }
+
+    /**
+     * @brief Minimum-time speed profile for the loaded robot and track
+     *
+     * Speeds are a Float32Array view into WASM memory, one per compiled
+     * track sample; valid until the next call.
+     */
+    val getVelocityProfile() {
+        val result = val::object();
+        if (!simulator_) {
+            return result;
+        }
+
+        profile_.compute(simulator_->getTrack(), VelocityLimits::fromConfig(simulator_->getConfig()));
+        const std::vector<float>& speed = profile_.speed();
+
+        result.set("speeds", val(typed_memory_view(speed.size(), speed.data())));
+        result.set("spacing", simulator_->getTrack().spacing());
+        result.set("lapTime", profile_.lapTime());
+        return result;
+    }
+
     /**
      * @brief Reset simulation
      */
@@ -87,7 +188,7 @@ public:
             return val::object();
         }
 
-        RobotState state = simulator_->getCurrentState();
+        const RobotState& state = simulator_->getCurrentState();
 
         // Create JavaScript object
         val stateObj = val::object();
@@ -105,7 +206,7 @@ public:
 
         // Sensor readings as array
         val sensorsArray = val::array();
-        for (size_t i = 0; i < state.sensorReadings.size(); i++) {
+        for (int i = 0; i < state.sensorCount; i++) {
             sensorsArray.set(i, state.sensorReadings[i]);
         }
         stateObj.set("sensors", sensorsArray);
@@ -145,6 +246,8 @@ public:
 
 private:
     std::unique_ptr<Simulator> simulator_;
+    std::vector<float> frameBuffer_;  // reused across runUntilDone calls
+    VelocityProfile profile_;         // backs getVelocityProfile's view
 };
 
 /**
@@ -160,6 +263,20 @@ public:
         params.useAnalytical = true;
         params.useNumerical = true;
         params.populationSize = 50;
+        params.sensorNoise = 0.02f;
+        params.tuneSpeed = false;
+        params.strategy = SearchStrategy::CMA_ES;
+        params.sigma = 0.3f;
+        params.restartPolicy = RestartPolicy::BIPOP;
+        params.maxRestarts = 4;
+        params.cacheSize = 4096;
+        params.timeBudget = 0.0f;
+        params.checkpointInterval = 0.0f;
+        params.scenarioCount = 0;
+        params.frictionSpread = 0.2f;
+        params.temperatureSpread = 10.0f;
+        params.robustObjective = RobustObjective::CVAR;
+        params.cvarAlpha = 0.25f;
 
         optimizer_ = std::make_unique<Optimizer>(params);
     }
@@ -168,39 +285,163 @@ public:
      * @brief Optimize configuration
      */
     val optimize(val configObj, val trackObj) {
-        // Parse configuration (similar to SimulatorWrapper)
-        RobotConfig config;
-        config.mass = configObj["mass"].as<float>();
-        config.wheelbase = configObj["wheelbase"].as<float>();
-        config.wheelDiameter = configObj["wheelDiameter"].as<float>();
-        config.maxSpeed = configObj["maxSpeed"].as<float>();
-        config.sensorCount = configObj["sensors"]["count"].as<int>();
-        config.sensorSpacing = configObj["sensors"]["spacing"].as<float>();
-        config.sensorHeight = configObj["sensors"]["height"].as<float>();
-        config.kp = configObj["pid"]["kp"].as<float>();
-        config.ki = configObj["pid"]["ki"].as<float>();
-        config.kd = configObj["pid"]["kd"].as<float>();
-        config.temperature = configObj["environment"]["temperature"].as<float>();
-        config.frictionCoeff = configObj["environment"]["friction"].as<float>();
-        config.gravity = configObj["environment"]["gravity"].as<float>();
-
-        // Parse track points
-        std::vector<TrackPoint> trackPoints;
-        val pointsArray = trackObj["points"];
-        int numPoints = pointsArray["length"].as<int>();
-
-        for (int i = 0; i < numPoints; i++) {
-            val point = pointsArray[i];
-            TrackPoint tp;
-            tp.x = point["x"].as<float>();
-            tp.y = point["y"].as<float>();
-            trackPoints.push_back(tp);
+        RobotConfig config = parseConfig(configObj);
+        std::vector<TrackPoint> trackPoints = parseTrack(trackObj);
+
+        OptimizationResult result = optimizer_->optimize(config, trackPoints, nullptr, bestCallback());
+        return toObject(result);
+    }
+
+    /**
+     * @brief Continue a run from checkpoint bytes (Uint8Array)
+     * @return Result object, or null if the checkpoint is invalid
+     */
+    val resume(val checkpointObj) {
+        std::vector<uint8_t> checkpoint = convertJSArrayToNumberVector<uint8_t>(checkpointObj);
+
+        OptimizationResult result;
+        if (!optimizer_->resumeFromBuffer(checkpoint, result, nullptr, bestCallback())) {
+            return val::null();
         }
+        return toObject(result);
+    }
+
+    /**
+     * @brief Relay-feedback PID tune ("zn", "tyreus-luyben" or "cohen-coon")
+     */
+    val quickTune(val configObj, val trackObj, std::string rule) {
+        TuningRule tuningRule = TuningRule::ZIEGLER_NICHOLS;
+        if (rule == "tyreus-luyben") {
+            tuningRule = TuningRule::TYREUS_LUYBEN;
+        } else if (rule == "cohen-coon") {
+            tuningRule = TuningRule::COHEN_COON;
+        }
+
+        RobotConfig tuned = optimizer_->optimizePID(parseConfig(configObj), parseTrack(trackObj), tuningRule);
+
+        val pidObj = val::object();
+        pidObj.set("kp", tuned.kp);
+        pidObj.set("ki", tuned.ki);
+        pidObj.set("kd", tuned.kd);
+        return pidObj;
+    }
 
-        // Run optimization
-        OptimizationResult result = optimizer_->optimize(config, trackPoints);
+    /**
+     * @brief Search algorithm of later optimize calls
+     *        ("cma-es", "gradient", "lbfgs", "hyperband" or "nsga2")
+     */
+    void setStrategy(std::string name) {
+        SearchStrategy strategy = SearchStrategy::CMA_ES;
+        if (name == "gradient") {
+            strategy = SearchStrategy::GRADIENT_DESCENT;
+        } else if (name == "lbfgs") {
+            strategy = SearchStrategy::LBFGS;
+        } else if (name == "hyperband") {
+            strategy = SearchStrategy::HYPERBAND;
+        } else if (name == "nsga2") {
+            strategy = SearchStrategy::NSGA2;
+        }
+        optimizer_->setStrategy(strategy);
+    }
 
-        // Convert result to JavaScript object
+    /**
+     * @brief Score later optimize calls across sampled environments
+     *        (objective "worst", "mean" or "cvar"; scenarioCount 0 = off)
+     */
+    void setRobust(int scenarioCount, float frictionSpread, float temperatureSpread,
+                   std::string objective, float cvarAlpha) {
+        RobustObjective robustObjective = RobustObjective::CVAR;
+        if (objective == "worst") {
+            robustObjective = RobustObjective::WORST_CASE;
+        } else if (objective == "mean") {
+            robustObjective = RobustObjective::MEAN;
+        }
+        optimizer_->setRobust(scenarioCount, frictionSpread, temperatureSpread, robustObjective, cvarAlpha);
+    }
+
+    /**
+     * @brief Wall-clock budget of later optimize calls (seconds, 0 = unlimited)
+     */
+    void setTimeBudget(float seconds) {
+        optimizer_->setTimeBudget(seconds);
+    }
+
+    /**
+     * @brief Function called with every new best result during optimize
+     */
+    void setBestCallback(val callback) {
+        onBest_ = callback;
+    }
+
+    /**
+     * @brief Wall-clock seconds between checkpoints (0 = none)
+     */
+    void setCheckpointInterval(float seconds) {
+        optimizer_->setCheckpointInterval(seconds);
+    }
+
+    /**
+     * @brief Function called with each checkpoint's bytes as a Uint8Array
+     *
+     * The view aliases WASM memory and is only valid during the call, so
+     * copy it (e.g. slice()) before storing it in IndexedDB.
+     */
+    void setCheckpointCallback(val callback) {
+        if (callback.isUndefined() || callback.isNull()) {
+            optimizer_->setCheckpointTarget("");
+            return;
+        }
+        optimizer_->setCheckpointTarget("", [callback](const std::vector<uint8_t>& checkpoint) {
+            callback(val(typed_memory_view(checkpoint.size(), checkpoint.data())));
+        });
+    }
+
+    /**
+     * @brief Most recent checkpoint as a Uint8Array view (empty before the first)
+     */
+    val getCheckpoint() {
+        const std::vector<uint8_t>& checkpoint = optimizer_->getCheckpoint();
+        return val(typed_memory_view(checkpoint.size(), checkpoint.data()));
+    }
+
+    /**
+     * @brief Cancel optimization
+     */
+    void cancel() {
+        if (optimizer_) {
+            optimizer_->cancel();
+        }
+    }
+
+private:
+    std::unique_ptr<Optimizer> optimizer_;
+    val onBest_ = val::undefined();
+
+    /**
+     * @brief Hook forwarding new best results to the JS callback, if set
+     */
+    Optimizer::BestCallback bestCallback() {
+        if (onBest_.isUndefined() || onBest_.isNull()) {
+            return nullptr;
+        }
+        return [this](const OptimizationResult& best) {
+            val bestObj = val::object();
+            bestObj.set("fitnessScore", best.fitnessScore);
+            bestObj.set("completionTime", best.completionTime);
+            bestObj.set("lapTimeBound", best.lapTimeBound);
+            bestObj.set("evaluations", static_cast<double>(best.evaluations));
+            bestObj.set("elapsedTime", best.elapsedTime);
+            bestObj.set("kp", best.optimalConfig.kp);
+            bestObj.set("ki", best.optimalConfig.ki);
+            bestObj.set("kd", best.optimalConfig.kd);
+            onBest_(bestObj);
+        };
+    }
+
+    /**
+     * @brief Convert an optimization result to a JavaScript object
+     */
+    val toObject(const OptimizationResult& result) const {
         val resultObj = val::object();
         resultObj.set("fitnessScore", result.fitnessScore);
         resultObj.set("completionTime", result.completionTime);
@@ -208,6 +449,14 @@ public:
         resultObj.set("iterations", result.iterations);
         resultObj.set("converged", result.converged);
         resultObj.set("strategy", result.strategy);
+        resultObj.set("lapTimeBound", result.lapTimeBound);
+        resultObj.set("evaluations", static_cast<double>(result.evaluations));
+        resultObj.set("elapsedTime", result.elapsedTime);
+        resultObj.set("worstCaseFitness", result.worstCaseFitness);
+        resultObj.set("meanFitness", result.meanFitness);
+        resultObj.set("cvarFitness", result.cvarFitness);
+        resultObj.set("cacheHits", static_cast<double>(optimizer_->getCacheHits()));
+        resultObj.set("cacheMisses", static_cast<double>(optimizer_->getCacheMisses()));
 
         // Optimal configuration
         val optimalConfigObj = val::object();
@@ -216,20 +465,24 @@ public:
         optimalConfigObj.set("kd", result.optimalConfig.kd);
         resultObj.set("optimalConfig", optimalConfigObj);
 
-        return resultObj;
-    }
-
-    /**
-     * @brief Cancel optimization
-     */
-    void cancel() {
-        if (optimizer_) {
-            optimizer_->cancel();
+        // Lap time / energy / tracking error trade-offs (NSGA-II)
+        val frontArray = val::array();
+        for (size_t i = 0; i < result.paretoFront.size(); i++) {
+            const ParetoPoint& point = result.paretoFront[i];
+            val pointObj = val::object();
+            pointObj.set("completionTime", point.completionTime);
+            pointObj.set("energyConsumption", point.energyConsumption);
+            pointObj.set("trackErrors", point.trackErrors);
+            pointObj.set("kp", point.config.kp);
+            pointObj.set("ki", point.config.ki);
+            pointObj.set("kd", point.config.kd);
+            pointObj.set("maxSpeed", point.config.maxSpeed);
+            frontArray.set(i, pointObj);
         }
-    }
+        resultObj.set("paretoFront", frontArray);
 
-private:
-    std::unique_ptr<Optimizer> optimizer_;
+        return resultObj;
+    }
 };
 
 /**
@@ -241,16 +494,28 @@ EMSCRIPTEN_BINDINGS(line_follower_simulator) {
         .constructor<>()
         .function("initialize", &SimulatorWrapper::initialize)
         .function("step", &SimulatorWrapper::step)
+        .function("runUntilDone", &SimulatorWrapper::runUntilDone)
         .function("reset", &SimulatorWrapper::reset)
         .function("getCurrentState", &SimulatorWrapper::getCurrentState)
         .function("isComplete", &SimulatorWrapper::isComplete)
         .function("hasFailed", &SimulatorWrapper::hasFailed)
         .function("getCompletionTime", &SimulatorWrapper::getCompletionTime)
+        .function("getVelocityProfile", &SimulatorWrapper::getVelocityProfile)
+        .function("setMPC", &SimulatorWrapper::setMPC)
         .function("updatePIDGains", &SimulatorWrapper::updatePIDGains);
 
     // Optimizer wrapper
     class_<OptimizerWrapper>("Optimizer")
         .constructor<>()
         .function("optimize", &OptimizerWrapper::optimize)
+        .function("quickTune", &OptimizerWrapper::quickTune)
+        .function("setStrategy", &OptimizerWrapper::setStrategy)
+        .function("setRobust", &OptimizerWrapper::setRobust)
+        .function("setTimeBudget", &OptimizerWrapper::setTimeBudget)
+        .function("setBestCallback", &OptimizerWrapper::setBestCallback)
+        .function("resume", &OptimizerWrapper::resume)
+        .function("setCheckpointInterval", &OptimizerWrapper::setCheckpointInterval)
+        .function("setCheckpointCallback", &OptimizerWrapper::setCheckpointCallback)
+        .function("getCheckpoint", &OptimizerWrapper::getCheckpoint)
         .function("cancel", &OptimizerWrapper::cancel);
 }
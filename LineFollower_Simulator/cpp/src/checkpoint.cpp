@@ -0,0 +1,179 @@
+/**
+ * @file checkpoint.cpp
+ * @brief Implementation of checkpoint buffers
+ */
+
+#include "../include/checkpoint.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace LineFollower {
+
+namespace {
+
+// "LFCK" and the layout version; bump the version on any format change
+constexpr uint32_t CHECKPOINT_MAGIC = 0x4B43464Cu;
+constexpr uint32_t CHECKPOINT_VERSION = 4;
+
+/**
+ * @brief FNV-1a over a byte range
+ */
+uint64_t checksum(const uint8_t* bytes, size_t count) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter() {
+    write(CHECKPOINT_MAGIC);
+    write(CHECKPOINT_VERSION);
+}
+
+void CheckpointWriter::write(const std::string& text) {
+    write(static_cast<uint32_t>(text.size()));
+    buffer_.insert(buffer_.end(), text.begin(), text.end());
+}
+
+void CheckpointWriter::write(const Eigen::MatrixXd& matrix) {
+    write(static_cast<uint32_t>(matrix.rows()));
+    write(static_cast<uint32_t>(matrix.cols()));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(matrix.data());
+    buffer_.insert(buffer_.end(), bytes, bytes + matrix.size() * sizeof(double));
+}
+
+void CheckpointWriter::write(const Eigen::VectorXd& vector) {
+    write(static_cast<uint32_t>(vector.size()));
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(vector.data());
+    buffer_.insert(buffer_.end(), bytes, bytes + vector.size() * sizeof(double));
+}
+
+void CheckpointWriter::write(const std::mt19937& rng) {
+    // The standard text form is the only portable way to get the state out
+    std::ostringstream stream;
+    stream << rng;
+    write(stream.str());
+}
+
+std::vector<uint8_t> CheckpointWriter::finish() {
+    write(checksum(buffer_.data(), buffer_.size()));
+    std::vector<uint8_t> checkpoint;
+    checkpoint.swap(buffer_);
+    return checkpoint;
+}
+
+bool CheckpointWriter::save(const std::string& path, const std::vector<uint8_t>& checkpoint) {
+    // Write beside the target and rename, so a crash mid-write leaves the
+    // previous checkpoint intact
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(checkpoint.data()), static_cast<std::streamsize>(checkpoint.size()));
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+CheckpointReader::CheckpointReader(const std::vector<uint8_t>& buffer)
+    : buffer_(buffer)
+    , offset_(0)
+    , limit_(0)
+    , ok_(false)
+{
+    uint64_t stored = 0;
+    if (buffer_.size() < 2 * sizeof(uint32_t) + sizeof(stored)) {
+        return;
+    }
+    limit_ = buffer_.size() - sizeof(stored);
+    std::memcpy(&stored, buffer_.data() + limit_, sizeof(stored));
+    ok_ = stored == checksum(buffer_.data(), limit_);
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    read(magic);
+    read(version);
+    ok_ = ok_ && magic == CHECKPOINT_MAGIC && version == CHECKPOINT_VERSION;
+}
+
+bool CheckpointReader::take(size_t bytes) {
+    if (!ok_ || bytes > limit_ - offset_) {
+        ok_ = false;
+        return false;
+    }
+    offset_ += bytes;
+    return true;
+}
+
+bool CheckpointReader::read(std::string& text) {
+    uint32_t length = 0;
+    if (!read(length) || !take(length)) {
+        return false;
+    }
+    const char* start = reinterpret_cast<const char*>(buffer_.data() + offset_ - length);
+    text.assign(start, length);
+    return true;
+}
+
+bool CheckpointReader::read(Eigen::MatrixXd& matrix) {
+    uint32_t rows = 0;
+    uint32_t cols = 0;
+    if (!read(rows) || !read(cols)) {
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(rows) * cols * sizeof(double);
+    if (!take(bytes)) {
+        return false;
+    }
+    matrix.resize(rows, cols);
+    std::memcpy(matrix.data(), buffer_.data() + offset_ - bytes, bytes);
+    return true;
+}
+
+bool CheckpointReader::read(Eigen::VectorXd& vector) {
+    uint32_t size = 0;
+    if (!read(size)) {
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(size) * sizeof(double);
+    if (!take(bytes)) {
+        return false;
+    }
+    vector.resize(size);
+    std::memcpy(vector.data(), buffer_.data() + offset_ - bytes, bytes);
+    return true;
+}
+
+bool CheckpointReader::read(std::mt19937& rng) {
+    std::string text;
+    if (!read(text)) {
+        return false;
+    }
+    std::istringstream stream(text);
+    stream >> rng;
+    if (stream.fail()) {
+        ok_ = false;
+    }
+    return ok_;
+}
+
+bool CheckpointReader::load(const std::string& path, std::vector<uint8_t>& buffer) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !file.bad();
+}
+
+} // namespace LineFollower
@@ -0,0 +1,210 @@
+/**
+ * @file compiled_track.cpp
+ * @brief Implementation of arc-length parameterized track
+ */
+
+#include "../include/compiled_track.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace LineFollower {
+
+namespace {
+
+// Minimum half-width of the curvature stencil (m). Smooths polyline corners
+// over a distance comparable to the robot's sensor bar.
+constexpr float CURVATURE_STENCIL = 0.02f;
+
+// Endpoints closer than this close the loop (m)
+constexpr float CLOSED_TOLERANCE = 1e-4f;
+
+} // namespace
+
+CompiledTrack::CompiledTrack(const std::vector<TrackPoint>& trackPoints, float spacing)
+    : spacing_(spacing)
+    , closed_(false)
+    , hash_(0)
+{
+    index_.build(trackPoints);
+
+    // FNV-1a over the coordinate bit patterns
+    hash_ = 1469598103934665603ull;
+    for (const TrackPoint& point : trackPoints) {
+        uint32_t bits[2];
+        std::memcpy(&bits[0], &point.x, sizeof(float));
+        std::memcpy(&bits[1], &point.y, sizeof(float));
+        for (uint32_t word : bits) {
+            for (int byte = 0; byte < 4; byte++) {
+                hash_ ^= (word >> (8 * byte)) & 0xFFu;
+                hash_ *= 1099511628211ull;
+            }
+        }
+    }
+
+    if (trackPoints.size() >= 3) {
+        const TrackPoint& first = trackPoints.front();
+        const TrackPoint& last = trackPoints.back();
+        closed_ = Physics::distance(Physics::Vec2(first.x, first.y), Physics::Vec2(last.x, last.y)) < CLOSED_TOLERANCE;
+    }
+
+    resample(spacing);
+    computeCurvature();
+    buildCurvatureTable();
+}
+
+void CompiledTrack::resample(float spacing) {
+    const std::vector<TrackPoint>& points = index_.points();
+    float total = length();
+
+    if (points.size() < 2 || total <= 0.0f) {
+        s_.assign(1, 0.0f);
+        x_.assign(1, points.empty() ? 0.0f : points[0].x);
+        y_.assign(1, points.empty() ? 0.0f : points[0].y);
+        heading_.assign(1, 0.0f);
+        spacing_ = 0.0f;
+        return;
+    }
+
+    // Divide the length evenly so the last sample lands on the end point
+    int intervals = std::max(1, static_cast<int>(std::ceil(total / spacing)));
+    spacing_ = total / static_cast<float>(intervals);
+
+    s_.resize(intervals + 1);
+    x_.resize(intervals + 1);
+    y_.resize(intervals + 1);
+    heading_.resize(intervals + 1);
+
+    int segment = 0;
+    int lastSegment = index_.segmentCount() - 1;
+    for (int k = 0; k <= intervals; k++) {
+        float target = k == intervals ? total : static_cast<float>(k) * spacing_;
+        while (segment < lastSegment && index_.pointArcLength(segment + 1) < target) {
+            segment++;
+        }
+
+        float start = index_.pointArcLength(segment);
+        float segmentLength = index_.pointArcLength(segment + 1) - start;
+        float t = segmentLength > 0.0f ? Physics::clamp((target - start) / segmentLength, 0.0f, 1.0f) : 0.0f;
+
+        s_[k] = target;
+        x_[k] = Physics::lerp(points[segment].x, points[segment + 1].x, t);
+        y_[k] = Physics::lerp(points[segment].y, points[segment + 1].y, t);
+    }
+
+    // Heading from central differences (one-sided at open ends)
+    for (int k = 0; k <= intervals; k++) {
+        int prev = k - 1;
+        int next = k + 1;
+        if (closed_) {
+            prev = (prev + intervals) % intervals;
+            next = next % intervals;
+        } else {
+            prev = std::max(prev, 0);
+            next = std::min(next, intervals);
+        }
+        heading_[k] = std::atan2(y_[next] - y_[prev], x_[next] - x_[prev]);
+    }
+}
+
+void CompiledTrack::computeCurvature() {
+    int n = size();
+    int intervals = n - 1;
+    curvature_.assign(n, 0.0f);
+    if (intervals < 2) {
+        return;
+    }
+
+    // The stencil must also span the original vertices, or curvature that
+    // the polyline concentrates at its corners shows up as spikes
+    float meanSegment = length() / static_cast<float>(index_.segmentCount());
+    float stencil = std::max(CURVATURE_STENCIL, meanSegment);
+    int w = std::max(1, static_cast<int>(std::round(stencil / spacing_)));
+    w = std::min(w, intervals / 2);
+
+    for (int k = 0; k < n; k++) {
+        int prev = k - w;
+        int next = k + w;
+        if (closed_) {
+            prev = ((prev % intervals) + intervals) % intervals;
+            next = next % intervals;
+        } else if (prev < 0 || next > intervals) {
+            continue;
+        }
+
+        Physics::Vec2 a(x_[prev], y_[prev]);
+        Physics::Vec2 b(x_[k], y_[k]);
+        Physics::Vec2 c(x_[next], y_[next]);
+        float kappa = Physics::calculateCurvature(a, b, c);
+        curvature_[k] = (b - a).cross(c - b) >= 0.0f ? kappa : -kappa;
+    }
+}
+
+void CompiledTrack::buildCurvatureTable() {
+    int n = size();
+    curvatureMax_.clear();
+    curvatureMax_.emplace_back(n);
+    for (int i = 0; i < n; i++) {
+        curvatureMax_[0][i] = std::abs(curvature_[i]);
+    }
+
+    for (int k = 1; (1 << k) <= n; k++) {
+        const std::vector<float>& below = curvatureMax_[k - 1];
+        int half = 1 << (k - 1);
+        int count = n - (1 << k) + 1;
+        std::vector<float> level(count);
+        for (int i = 0; i < count; i++) {
+            level[i] = std::max(below[i], below[i + half]);
+        }
+        curvatureMax_.push_back(std::move(level));
+    }
+}
+
+int CompiledTrack::sampleAt(float arcLength) const {
+    if (spacing_ <= 0.0f) {
+        return 0;
+    }
+    int k = static_cast<int>(std::lround(arcLength / spacing_));
+    return Physics::clamp(k, 0, size() - 1);
+}
+
+float CompiledTrack::curvatureAt(float arcLength) const {
+    if (spacing_ <= 0.0f) {
+        return 0.0f;
+    }
+    float position = Physics::clamp(arcLength / spacing_, 0.0f, static_cast<float>(size() - 1));
+    int k = std::min(static_cast<int>(position), size() - 2);
+    if (k < 0) {
+        return curvature_[0];
+    }
+    return Physics::lerp(curvature_[k], curvature_[k + 1], position - static_cast<float>(k));
+}
+
+float CompiledTrack::maxCurvature(float from, float to) const {
+    int i = sampleAt(from);
+    int j = sampleAt(to);
+    if (i > j) {
+        std::swap(i, j);
+    }
+
+    // Two overlapping power-of-two windows cover [i, j]
+    int k = std::ilogb(static_cast<double>(j - i + 1));
+    return std::max(curvatureMax_[k][i], curvatureMax_[k][j - (1 << k) + 1]);
+}
+
+int CompiledTrack::segmentAt(float arcLength) const {
+    int low = 0;
+    int high = index_.segmentCount() - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (index_.pointArcLength(mid) <= arcLength) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return std::max(low, 0);
+}
+
+} // namespace LineFollower
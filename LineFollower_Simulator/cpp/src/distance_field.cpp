@@ -0,0 +1,186 @@
+/**
+ * @file distance_field.cpp
+ * @brief Implementation of tiled track distance field
+ */
+
+#include "../include/distance_field.hpp"
+#include "../include/track_index.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LineFollower {
+
+namespace {
+
+// Minimum resident tiles when a memory limit is set
+constexpr size_t MIN_RESIDENT_TILES = 4;
+
+} // namespace
+
+DistanceField::DistanceField(const TrackIndex& index, float resolution, float maxDistance, size_t memoryLimit)
+    : index_(index)
+    , resolution_(resolution)
+    , invResolution_(1.0f / resolution)
+    , maxDistance_(maxDistance)
+    , originX_(0.0f)
+    , originY_(0.0f)
+    , tilesX_(0)
+    , tilesY_(0)
+    , maxResident_(0)
+    , useCounter_(0)
+    , tilesBuilt_(0)
+{
+    const std::vector<TrackPoint>& points = index_.points();
+    if (points.empty()) {
+        return;
+    }
+
+    // Track bounding box grown by the clamp distance
+    float minX = points[0].x, maxX = points[0].x;
+    float minY = points[0].y, maxY = points[0].y;
+    for (const TrackPoint& p : points) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    originX_ = minX - maxDistance_;
+    originY_ = minY - maxDistance_;
+
+    float tileExtent = TILE_SIZE * resolution_;
+    tilesX_ = static_cast<int>(std::ceil((maxX - minX + 2.0f * maxDistance_) / tileExtent)) + 1;
+    tilesY_ = static_cast<int>(std::ceil((maxY - minY + 2.0f * maxDistance_) / tileExtent)) + 1;
+    tileSlot_.assign(static_cast<size_t>(tilesX_) * tilesY_, TILE_UNBUILT);
+
+    if (memoryLimit > 0) {
+        size_t tileBytes = TILE_SAMPLES * TILE_SAMPLES * sizeof(float);
+        maxResident_ = std::max(memoryLimit / tileBytes, MIN_RESIDENT_TILES);
+        tiles_.reserve(std::min(maxResident_, tileSlot_.size()));
+    }
+}
+
+float DistanceField::sample(float x, float y) {
+    float gx = (x - originX_) * invResolution_;
+    float gy = (y - originY_) * invResolution_;
+    if (gx < 0.0f || gy < 0.0f ||
+        gx >= static_cast<float>(tilesX_ * TILE_SIZE) ||
+        gy >= static_cast<float>(tilesY_ * TILE_SIZE)) {
+        return maxDistance_;
+    }
+
+    int ix = static_cast<int>(gx);
+    int iy = static_cast<int>(gy);
+    float fx = gx - static_cast<float>(ix);
+    float fy = gy - static_cast<float>(iy);
+
+    const float* s = acquireTile(ix / TILE_SIZE, iy / TILE_SIZE);
+    if (!s) {
+        return maxDistance_;
+    }
+
+    int lx = ix % TILE_SIZE;
+    int ly = iy % TILE_SIZE;
+    float v00 = s[ly * TILE_SAMPLES + lx];
+    float v10 = s[ly * TILE_SAMPLES + lx + 1];
+    float v01 = s[(ly + 1) * TILE_SAMPLES + lx];
+    float v11 = s[(ly + 1) * TILE_SAMPLES + lx + 1];
+
+    // Signed interpolation is only valid in cells the line passes through;
+    // elsewhere a sign change marks the midline between two track branches
+    bool mixed = (v00 < 0.0f) != (v10 < 0.0f) || (v00 < 0.0f) != (v01 < 0.0f) || (v00 < 0.0f) != (v11 < 0.0f);
+    float largest = std::max(std::max(std::abs(v00), std::abs(v10)), std::max(std::abs(v01), std::abs(v11)));
+    if (mixed && largest > 1.5f * resolution_) {
+        v00 = std::abs(v00);
+        v10 = std::abs(v10);
+        v01 = std::abs(v01);
+        v11 = std::abs(v11);
+    }
+
+    float top = Physics::lerp(v00, v10, fx);
+    float bottom = Physics::lerp(v01, v11, fx);
+    return std::min(std::abs(Physics::lerp(top, bottom, fy)), maxDistance_);
+}
+
+size_t DistanceField::memoryUsage() const {
+    return tiles_.size() * TILE_SAMPLES * TILE_SAMPLES * sizeof(float);
+}
+
+const float* DistanceField::acquireTile(int tx, int ty) {
+    int tileIndex = ty * tilesX_ + tx;
+    int slot = tileSlot_[tileIndex];
+
+    if (slot >= 0) {
+        tiles_[slot].lastUse = ++useCounter_;
+        return tiles_[slot].samples.data();
+    }
+    if (slot == TILE_EMPTY) {
+        return nullptr;
+    }
+
+    if (!tileNearLine(tx, ty)) {
+        tileSlot_[tileIndex] = TILE_EMPTY;
+        return nullptr;
+    }
+
+    // New slot while under the limit, otherwise recycle the least recently used
+    if (maxResident_ == 0 || tiles_.size() < maxResident_) {
+        tiles_.emplace_back();
+        slot = static_cast<int>(tiles_.size()) - 1;
+    } else {
+        slot = 0;
+        for (size_t i = 1; i < tiles_.size(); i++) {
+            if (tiles_[i].lastUse < tiles_[slot].lastUse) {
+                slot = static_cast<int>(i);
+            }
+        }
+        tileSlot_[tiles_[slot].tileIndex] = TILE_UNBUILT;
+    }
+
+    Tile& tile = tiles_[slot];
+    buildTile(tx, ty, tile.samples);
+    tile.tileIndex = tileIndex;
+    tile.lastUse = ++useCounter_;
+    tileSlot_[tileIndex] = slot;
+    tilesBuilt_++;
+
+    return tile.samples.data();
+}
+
+bool DistanceField::tileNearLine(int tx, int ty) const {
+    float extent = TILE_SIZE * resolution_;
+    float centerX = originX_ + (static_cast<float>(tx) + 0.5f) * extent;
+    float centerY = originY_ + (static_cast<float>(ty) + 0.5f) * extent;
+    float reach = 0.5f * extent * std::sqrt(2.0f) + maxDistance_;
+    return index_.distance(centerX, centerY, reach) < reach;
+}
+
+void DistanceField::buildTile(int tx, int ty, std::vector<float>& samples) const {
+    samples.resize(TILE_SAMPLES * TILE_SAMPLES);
+
+    for (int j = 0; j < TILE_SAMPLES; j++) {
+        float y = originY_ + static_cast<float>(ty * TILE_SIZE + j) * resolution_;
+        for (int i = 0; i < TILE_SAMPLES; i++) {
+            float x = originX_ + static_cast<float>(tx * TILE_SIZE + i) * resolution_;
+            samples[j * TILE_SAMPLES + i] = signedDistance(x, y);
+        }
+    }
+}
+
+float DistanceField::signedDistance(float x, float y) const {
+    int segment;
+    float t;
+    float d = index_.nearest(x, y, maxDistance_, segment, t);
+    if (segment < 0) {
+        return maxDistance_;
+    }
+
+    // Positive to the left of the segment direction
+    const std::vector<TrackPoint>& points = index_.points();
+    const TrackPoint& a = points[segment];
+    const TrackPoint& b = points[segment + 1];
+    float side = (b.x - a.x) * (y - a.y) - (b.y - a.y) * (x - a.x);
+    return side >= 0.0f ? d : -d;
+}
+
+} // namespace LineFollower
@@ -4,13 +4,331 @@
  */
 
 #include "../include/optimizer.hpp"
+#include "../include/simulator_batch.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/thread_pool.hpp"
+#include "../include/velocity_profile.hpp"
+#include "../include/checkpoint.hpp"
+#include "../include/physics.hpp"
+#include "../include/optimizers/cma_es.hpp"
+#include "../include/optimizers/lbfgs.hpp"
+#include "../include/optimizers/nsga2.hpp"
+#include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <utility>
 
 namespace LineFollower {
 
+namespace {
+
+// Fixed control period used for fitness evaluation
+constexpr float SIMULATION_DT = 0.001f;
+
+// Fitness weights of lap time and tracking error; they sum to one
+constexpr float FITNESS_TIME_WEIGHT = 0.7f;
+constexpr float FITNESS_ERROR_WEIGHT = 0.3f;
+
+// Finite-difference steps: initial fraction of the value, absolute floor
+// per parameter (kp, ki, kd, maxSpeed) and largest fraction allowed
+constexpr float GRADIENT_RELATIVE_STEP = 0.05f;
+constexpr float GRADIENT_MIN_STEP[4] = {0.001f, 0.001f, 0.001f, 0.01f};
+constexpr float GRADIENT_MAX_RELATIVE_STEP = 0.25f;
+
+// Lower bound of each parameter during search (kp, ki, kd, maxSpeed)
+constexpr float PARAMETER_MIN[4] = {0.0f, 0.0f, 0.0f, 0.05f};
+
+// Fitness differences below this are treated as unresolved
+constexpr float GRADIENT_RESOLUTION = 1e-6f;
+
+// Smallest first line-search step; learningRate is clamped to [this, 1]
+constexpr float MIN_LEARNING_RATE = 1e-4f;
+
+// CMA-ES: seed of the BIPOP regime and population-size draws
+constexpr uint32_t CMA_RESTART_SEED = 12345;
+
+// Hyperband: rung growth factor and rung count of the widest bracket
+// (first rung = 1/27 of the lap), plus the control period below full laps
+constexpr int HYPERBAND_ETA = 3;
+constexpr int HYPERBAND_MAX_BRACKET = 3;
+constexpr float PREFIX_DT = 0.002f;
+
+// Hyperband: seed of the log-uniform configuration sampler
+constexpr uint32_t HYPERBAND_SEED = 12345;
+
+// NSGA-II: search box up to this multiple of each initial value, the
+// variation operators' seed and the noise seed shared by every generation
+constexpr double NSGA2_RANGE = 4.0;
+constexpr uint32_t NSGA2_SEED = 12345;
+constexpr uint32_t NSGA2_NOISE_SEED = 1;
+
+// NSGA-II: generations in a row without a better value of any objective
+// on the first front before the search counts as converged
+constexpr int NSGA2_STALL_GENERATIONS = 10;
+
+// Robust scenarios: sampling seed (fixed, so a resumed search sees the same
+// set) and the lowest friction a scenario may reach
+constexpr uint32_t SCENARIO_SEED = 12345;
+constexpr float SCENARIO_MIN_FRICTION = 0.05f;
+
+// Simulation steps between checks for cancel() and the deadline
+constexpr int STOP_CHECK_STEPS = 1024;
+
+// Lockstep batches per pool thread: a batch runs until its slowest robot
+// finishes, so a few per thread let work stealing even out the load
+constexpr int BATCHES_PER_THREAD = 2;
+
+// Configurations closer than this in every field share a cache entry
+constexpr double CACHE_QUANTUM = 1e-4;
+
+// Relay experiment: output (PID control units), switching band (line-error
+// units), course shape and the half-cycles discarded as start-up transient
+constexpr float RELAY_AMPLITUDE = 0.2f;
+constexpr float RELAY_HYSTERESIS = 0.02f;
+constexpr float RELAY_STRAIGHT = 1.5f;
+constexpr float RELAY_MIN_RADIUS = 0.2f;
+constexpr float RELAY_MAX_RADIUS = 2.0f;
+constexpr float RELAY_MAX_TIME = 10.0f;
+constexpr int RELAY_SKIPPED_HALF_CYCLES = 2;
+constexpr int RELAY_MIN_HALF_CYCLES = 4;
+
+// Keeps the fitted dead-time phase strictly inside (pi/2, pi)
+constexpr float PHASE_MARGIN = 0.05f;
+
+uint64_t hashCombine(uint64_t seed, uint64_t value) {
+    uint64_t x = seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2));
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+uint64_t quantize(float value) {
+    return static_cast<uint64_t>(std::llround(static_cast<double>(value) / CACHE_QUANTUM));
+}
+
+/**
+ * @brief Cache key of one simulation: everything that determines its result
+ */
+uint64_t evaluationKey(
+    const RobotConfig& config,
+    uint64_t trackHash,
+    float sensorNoise,
+    uint32_t noiseSeed,
+    float cutoffTime,
+    const Fidelity& fidelity)
+{
+    const float fields[] = {
+        config.mass, config.wheelbase, config.wheelDiameter, config.maxSpeed,
+        config.sensorSpacing, config.sensorHeight, config.kp, config.ki, config.kd,
+        config.temperature, config.frictionCoeff, config.gravity,
+        sensorNoise, cutoffTime, fidelity.arcLength, fidelity.dt
+    };
+
+    uint64_t key = hashCombine(trackHash, static_cast<uint64_t>(config.sensorCount));
+    for (float field : fields) {
+        key = hashCombine(key, quantize(field));
+    }
+    // The seed only matters when there is noise to seed
+    return hashCombine(key, sensorNoise > 0.0f ? noiseSeed : 0u);
+}
+
+/**
+ * @brief Tunable parameter by gradient index: kp, ki, kd, maxSpeed
+ */
+float& parameter(RobotConfig& config, int index) {
+    switch (index) {
+        case 0: return config.kp;
+        case 1: return config.ki;
+        case 2: return config.kd;
+        default: return config.maxSpeed;
+    }
+}
+
+float parameter(const RobotConfig& config, int index) {
+    switch (index) {
+        case 0: return config.kp;
+        case 1: return config.ki;
+        case 2: return config.kd;
+        default: return config.maxSpeed;
+    }
+}
+
+/**
+ * @brief Unit of a parameter in the relative search coordinates
+ *
+ * The parameter's magnitude, floored so that a zero gain still gets the
+ * smallest finite-difference step's worth of room.
+ */
+float parameterScale(const RobotConfig& config, int index) {
+    return std::max(std::abs(parameter(config, index)), GRADIENT_MIN_STEP[index] / GRADIENT_RELATIVE_STEP);
+}
+
+/**
+ * @brief Limit cycle measured in a relay experiment
+ */
+struct RelayCycle {
+    float ultimateGain;      // describing-function gain at the cycle frequency
+    float ultimatePeriod;    // s
+    float deadTime;          // mean time from a relay switch to the error's turn (s)
+};
+
+/**
+ * @brief Straight along +x ending in a left-hand quarter turn of a radius
+ */
+std::vector<TrackPoint> relayCourse(float radius) {
+    std::vector<TrackPoint> points;
+    const int straightPoints = 16;
+    for (int i = 0; i <= straightPoints; i++) {
+        points.push_back({RELAY_STRAIGHT * static_cast<float>(i) / straightPoints, 0.0f});
+    }
+    const int arcPoints = 32;
+    for (int i = 1; i <= arcPoints; i++) {
+        float angle = 0.5f * Physics::PI * static_cast<float>(i) / arcPoints;
+        points.push_back({RELAY_STRAIGHT + radius * std::sin(angle), radius * (1.0f - std::cos(angle))});
+    }
+    return points;
+}
+
+/**
+ * @brief Extract the limit cycle from a relay experiment's error trace
+ *
+ * Replays the relay's switching on the recorded errors. Each half-cycle
+ * runs from one switch to the next; its extreme error gives the amplitude
+ * and the delay from the switch to that extreme the apparent dead time.
+ *
+ * @param errors Line error at every control step
+ * @param dt Control period (s)
+ * @param cycle Output cycle
+ * @return false if too few half-cycles were completed
+ */
+bool analyzeRelay(const std::vector<float>& errors, float dt, RelayCycle& cycle) {
+    if (errors.empty()) {
+        return false;
+    }
+
+    float relay = errors[0] >= 0.0f ? 1.0f : -1.0f;
+    int lastSwitch = -1;
+    int halfCycles = 0;
+    int measured = 0;
+    float duration = 0.0f;
+    float delay = 0.0f;
+    float highPeaks = 0.0f;
+    float lowPeaks = 0.0f;
+    int highCount = 0;
+    int lowCount = 0;
+
+    for (int i = 0; i < static_cast<int>(errors.size()); i++) {
+        float next = relay;
+        if (errors[i] > RELAY_HYSTERESIS) {
+            next = 1.0f;
+        } else if (errors[i] < -RELAY_HYSTERESIS) {
+            next = -1.0f;
+        }
+        if (next == relay) {
+            continue;
+        }
+
+        if (lastSwitch >= 0) {
+            halfCycles++;
+            if (halfCycles > RELAY_SKIPPED_HALF_CYCLES) {
+                // The error kept moving against the old output until it turned
+                int peak = lastSwitch;
+                for (int j = lastSwitch; j < i; j++) {
+                    if (relay * errors[j] > relay * errors[peak]) {
+                        peak = j;
+                    }
+                }
+                if (relay > 0.0f) {
+                    highPeaks += errors[peak];
+                    highCount++;
+                } else {
+                    lowPeaks += errors[peak];
+                    lowCount++;
+                }
+                duration += static_cast<float>(i - lastSwitch) * dt;
+                delay += static_cast<float>(peak - lastSwitch) * dt;
+                measured++;
+            }
+        }
+        relay = next;
+        lastSwitch = i;
+    }
+
+    if (measured < RELAY_MIN_HALF_CYCLES || highCount == 0 || lowCount == 0) {
+        return false;
+    }
+
+    float amplitude = 0.5f * (highPeaks / highCount - lowPeaks / lowCount);
+    if (amplitude <= RELAY_HYSTERESIS) {
+        return false;
+    }
+
+    // Describing function of a relay with hysteresis
+    cycle.ultimateGain = 4.0f * RELAY_AMPLITUDE /
+        (Physics::PI * std::sqrt(amplitude * amplitude - RELAY_HYSTERESIS * RELAY_HYSTERESIS));
+    cycle.ultimatePeriod = 2.0f * duration / measured;
+    cycle.deadTime = delay / measured;
+    return true;
+}
+
+/**
+ * @brief Objectives of the first front of the last NSGA-II generation
+ */
+std::vector<Eigen::VectorXd> frontObjectives(const Optimizers::NSGA2& nsga) {
+    std::vector<Eigen::VectorXd> front;
+    if (nsga.generation() > 0) {
+        for (int k : nsga.front()) {
+            front.push_back(nsga.objectives()[k]);
+        }
+    }
+    return front;
+}
+
+/**
+ * @brief Whether a front's best value of every objective matches the
+ *        previous front's, within the tolerance relative to its spread
+ *
+ * The ideal point only; the far end of the front keeps moving as crowding
+ * spreads it and is no sign of progress.
+ */
+bool frontSettled(const std::vector<Eigen::VectorXd>& previous,
+                  const std::vector<Eigen::VectorXd>& front,
+                  double tolerance)
+{
+    if (previous.empty() || front.empty()) {
+        return false;
+    }
+    Eigen::VectorXd idealBefore = previous[0];
+    Eigen::VectorXd nadirBefore = previous[0];
+    for (const Eigen::VectorXd& f : previous) {
+        idealBefore = idealBefore.cwiseMin(f);
+        nadirBefore = nadirBefore.cwiseMax(f);
+    }
+    Eigen::VectorXd ideal = front[0];
+    for (const Eigen::VectorXd& f : front) {
+        ideal = ideal.cwiseMin(f);
+    }
+    Eigen::ArrayXd spread = (nadirBefore - idealBefore).array().max(tolerance);
+    return ((ideal - idealBefore).array().abs() <= tolerance * spread).all();
+}
+
+} // namespace
+
 Optimizer::Optimizer(const OptimizationParams& params)
     : params_(params)
     , cancelled_(false)
+    , evaluations_(0)
+    , elapsedBefore_(0.0f)
+    , resume_(nullptr)
+    , resumeFailed_(false)
+    , pool_(std::make_unique<ThreadPool>())
+    , cache_(static_cast<size_t>(std::max(0, params.cacheSize)))
 {
 }
 
@@ -20,24 +338,357 @@ Optimizer::~Optimizer() {
 OptimizationResult Optimizer::optimize(
     const RobotConfig& initialConfig,
     const std::vector<TrackPoint>& trackPoints,
-    std::function<void(float)> progressCallback)
+    std::function<void(float)> progressCallback,
+    BestCallback bestCallback)
+{
+    gradientSteps_.clear();
+    evaluations_ = 0;
+    elapsedBefore_ = 0.0f;
+    best_ = OptimizationResult();
+    best_.fitnessScore = -1.0f;
+    resume_ = nullptr;
+
+    // Compile once; every candidate simulator reads the same copy
+    auto track = std::make_shared<const CompiledTrack>(trackPoints);
+
+    return search(initialConfig, track, progressCallback, bestCallback);
+}
+
+OptimizationResult Optimizer::search(
+    const RobotConfig& initialConfig,
+    const std::shared_ptr<const CompiledTrack>& track,
+    std::function<void(float)> progressCallback,
+    BestCallback bestCallback)
 {
     cancelled_ = false;
+    startTime_ = std::chrono::steady_clock::now();
+    deadline_ = startTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(std::max(0.0f, params_.timeBudget)));
+    lastCheckpoint_ = startTime_;
+    bestCallback_ = bestCallback;
+    initialConfig_ = initialConfig;
+    track_ = track;
+    resumeFailed_ = false;
+    sampleScenarios();
 
     // TODO: Implement artifact-based optimization in Phase 2
-    // For Phase 1, use simple gradient descent
+    // For Phase 1, tune the whole configuration with a global search
+
+    OptimizationResult result;
+    if (params_.strategy == SearchStrategy::CMA_ES) {
+        result = cmaEs(initialConfig, track, progressCallback);
+    } else if (params_.strategy == SearchStrategy::LBFGS) {
+        result = lbfgs(initialConfig, track, progressCallback);
+    } else if (params_.strategy == SearchStrategy::HYPERBAND) {
+        result = hyperband(initialConfig, track, progressCallback);
+    } else if (params_.strategy == SearchStrategy::NSGA2) {
+        result = nsga2(initialConfig, track, progressCallback);
+    } else {
+        result = gradientDescent(initialConfig, track, progressCallback);
+    }
+    resume_ = nullptr;
+    if (resumeFailed_) {
+        bestCallback_ = nullptr;
+        track_.reset();
+        return result;
+    }
+
+    // A stopped search may not have folded its last evaluations in yet
+    bool stopped = stopRequested();
+    if (best_.fitnessScore > result.fitnessScore) {
+        result.optimalConfig = best_.optimalConfig;
+        result.fitnessScore = best_.fitnessScore;
+        result.completionTime = best_.completionTime;
+        result.averageSpeed = best_.averageSpeed;
+    }
+    if (stopped) {
+        result.converged = false;
+        result.strategy += cancelled_ ? ", cancelled" : ", time budget reached";
+    }
+    bestCallback_ = nullptr;
 
-    return gradientDescent(initialConfig, trackPoints, progressCallback);
+    // Score the winner under every risk measure with one batch of scenario
+    // runs. A stopped search skips it, and so does one stopped during it;
+    // the risk fields then keep the nominal score.
+    result.worstCaseFitness = result.fitnessScore;
+    result.meanFitness = result.fitnessScore;
+    result.cvarFitness = result.fitnessScore;
+    if (!scenarios_.empty() && !stopped) {
+        std::vector<SimulationMetrics> runs =
+            simulatePopulation(scenarioVariants({result.optimalConfig}), track, 0.0f, 0, Fidelity{0.0f, 0.0f});
+        SimulationMetrics worst = tailAverage(runs, tailShare(RobustObjective::WORST_CASE), track->length());
+        if (!worst.interrupted) {
+            result.worstCaseFitness = calculateFitness(worst);
+            result.meanFitness = calculateFitness(tailAverage(runs, tailShare(RobustObjective::MEAN), track->length()));
+            result.cvarFitness = calculateFitness(tailAverage(runs, tailShare(RobustObjective::CVAR), track->length()));
+            result.strategy += ", robust over " + std::to_string(scenarios_.size()) + " scenarios";
+        }
+    }
+
+    // How far the tuned robot is from what its grip and motors allow
+    VelocityProfile profile;
+    profile.compute(*track, VelocityLimits::fromConfig(result.optimalConfig));
+    result.lapTimeBound = profile.lapTime();
+    result.evaluations = evaluations_;
+    result.elapsedTime = elapsedBefore_ +
+        std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime_).count();
+    track_.reset();
+    return result;
+}
+
+bool Optimizer::resume(
+    const std::string& path,
+    OptimizationResult& result,
+    std::function<void(float)> progressCallback,
+    BestCallback bestCallback)
+{
+    std::vector<uint8_t> checkpoint;
+    if (!CheckpointReader::load(path, checkpoint)) {
+        return false;
+    }
+    return resumeFromBuffer(checkpoint, result, progressCallback, bestCallback);
+}
+
+bool Optimizer::resumeFromBuffer(
+    const std::vector<uint8_t>& checkpoint,
+    OptimizationResult& result,
+    std::function<void(float)> progressCallback,
+    BestCallback bestCallback)
+{
+    CheckpointReader in(checkpoint);
+
+    // Search-defining parameters; budget, cache size and checkpointing stay ours
+    OptimizationParams params = params_;
+    int32_t strategy = 0;
+    int32_t restartPolicy = 0;
+    int32_t maxIterations = 0;
+    int32_t populationSize = 0;
+    int32_t maxRestarts = 0;
+    in.read(strategy);
+    in.read(restartPolicy);
+    in.read(maxIterations);
+    in.read(populationSize);
+    in.read(maxRestarts);
+    in.read(params.tolerance);
+    in.read(params.learningRate);
+    in.read(params.sensorNoise);
+    in.read(params.sigma);
+    in.read(params.tuneSpeed);
+    int32_t scenarioCount = 0;
+    int32_t robustObjective = 0;
+    in.read(scenarioCount);
+    in.read(params.frictionSpread);
+    in.read(params.temperatureSpread);
+    in.read(robustObjective);
+    in.read(params.cvarAlpha);
+
+    RobotConfig initialConfig;
+    std::vector<TrackPoint> trackPoints;
+    int64_t evaluations = 0;
+    float elapsed = 0.0f;
+    OptimizationResult best;
+    std::vector<float> gradientSteps;
+    in.read(initialConfig);
+    in.read(trackPoints);
+    in.read(evaluations);
+    in.read(elapsed);
+    in.read(best.optimalConfig);
+    in.read(best.fitnessScore);
+    in.read(best.completionTime);
+    in.read(best.averageSpeed);
+    in.read(gradientSteps);
+
+    uint32_t cacheEntries = 0;
+    in.read(cacheEntries);
+    std::vector<std::pair<uint64_t, SimulationMetrics>> entries;
+    for (uint32_t i = 0; i < cacheEntries && in.ok(); i++) {
+        std::pair<uint64_t, SimulationMetrics> entry;
+        in.read(entry.first);
+        in.read(entry.second);
+        entries.push_back(entry);
+    }
+
+    if (!in.ok() || trackPoints.size() < 2 ||
+        strategy < 0 || strategy > static_cast<int32_t>(SearchStrategy::NSGA2) ||
+        restartPolicy < 0 || restartPolicy > static_cast<int32_t>(RestartPolicy::BIPOP) ||
+        robustObjective < 0 || robustObjective > static_cast<int32_t>(RobustObjective::CVAR)) {
+        return false;
+    }
+
+    params.strategy = static_cast<SearchStrategy>(strategy);
+    params.restartPolicy = static_cast<RestartPolicy>(restartPolicy);
+    params.maxIterations = maxIterations;
+    params.populationSize = populationSize;
+    params.maxRestarts = maxRestarts;
+    params.scenarioCount = scenarioCount;
+    params.robustObjective = static_cast<RobustObjective>(robustObjective);
+
+    // The strategy state is only read inside search(), so keep ours aside
+    // and put it back if that read fails
+    OptimizationParams previousParams = params_;
+    LRUCache<SimulationMetrics> previousCache = std::move(cache_);
+    std::vector<float> previousSteps = gradientSteps_;
+    long previousEvaluations = evaluations_;
+    float previousElapsed = elapsedBefore_;
+    OptimizationResult previousBest = best_;
+
+    params_ = params;
+    cache_ = LRUCache<SimulationMetrics>(previousCache.capacity());
+    for (const auto& entry : entries) {
+        cache_.insert(entry.first, entry.second);
+    }
+    gradientSteps_ = gradientSteps;
+    evaluations_ = static_cast<long>(evaluations);
+    elapsedBefore_ = elapsed;
+    best_ = best;
+
+    // The strategy picks up its own state from the rest of the checkpoint
+    resume_ = &in;
+    result = search(initialConfig, std::make_shared<const CompiledTrack>(trackPoints),
+                    progressCallback, bestCallback);
+    if (resumeFailed_) {
+        params_ = previousParams;
+        cache_ = std::move(previousCache);
+        gradientSteps_ = previousSteps;
+        evaluations_ = previousEvaluations;
+        elapsedBefore_ = previousElapsed;
+        best_ = previousBest;
+        return false;
+    }
+    result.strategy += " (resumed)";
+    return true;
+}
+
+void Optimizer::setCheckpointTarget(const std::string& path, CheckpointCallback callback) {
+    checkpointPath_ = path;
+    checkpointCallback_ = callback;
+}
+
+void Optimizer::checkpoint(const std::function<void(CheckpointWriter&)>& writeState, bool force) {
+    if (params_.checkpointInterval <= 0.0f) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (!force && std::chrono::duration<float>(now - lastCheckpoint_).count() < params_.checkpointInterval) {
+        return;
+    }
+    lastCheckpoint_ = now;
+
+    CheckpointWriter out;
+    out.write(static_cast<int32_t>(params_.strategy));
+    out.write(static_cast<int32_t>(params_.restartPolicy));
+    out.write(static_cast<int32_t>(params_.maxIterations));
+    out.write(static_cast<int32_t>(params_.populationSize));
+    out.write(static_cast<int32_t>(params_.maxRestarts));
+    out.write(params_.tolerance);
+    out.write(params_.learningRate);
+    out.write(params_.sensorNoise);
+    out.write(params_.sigma);
+    out.write(params_.tuneSpeed);
+    out.write(static_cast<int32_t>(params_.scenarioCount));
+    out.write(params_.frictionSpread);
+    out.write(params_.temperatureSpread);
+    out.write(static_cast<int32_t>(params_.robustObjective));
+    out.write(params_.cvarAlpha);
+
+    out.write(initialConfig_);
+    out.write(track_->points());
+    out.write(static_cast<int64_t>(evaluations_));
+    out.write(elapsedBefore_ + std::chrono::duration<float>(now - startTime_).count());
+    out.write(best_.optimalConfig);
+    out.write(best_.fitnessScore);
+    out.write(best_.completionTime);
+    out.write(best_.averageSpeed);
+    out.write(gradientSteps_);
+
+    out.write(static_cast<uint32_t>(cache_.size()));
+    cache_.forEach([&](uint64_t key, const SimulationMetrics& metrics) {
+        out.write(key);
+        out.write(metrics);
+    });
+
+    writeState(out);
+    checkpoint_ = out.finish();
+
+    if (!checkpointPath_.empty()) {
+        CheckpointWriter::save(checkpointPath_, checkpoint_);
+    }
+    if (checkpointCallback_) {
+        checkpointCallback_(checkpoint_);
+    }
 }
 
 RobotConfig Optimizer::optimizePID(
     const RobotConfig& config,
-    const std::vector<TrackPoint>& trackPoints)
+    const std::vector<TrackPoint>& trackPoints,
+    TuningRule rule)
 {
-    // TODO: Implement Ziegler-Nichols or similar PID tuning method
     RobotConfig optimized = config;
 
-    // Placeholder: return unchanged
+    // The curve matches the track's tightest so the cycle reflects it
+    float radius = RELAY_MAX_RADIUS;
+    if (trackPoints.size() >= 2) {
+        CompiledTrack track(trackPoints);
+        float curvature = track.maxCurvature(0.0f, track.length());
+        if (curvature > 0.0f) {
+            radius = 1.0f / curvature;
+        }
+    }
+    radius = Physics::clamp(radius, RELAY_MIN_RADIUS, RELAY_MAX_RADIUS);
+
+    Simulator simulator(config, relayCourse(radius));
+    if (!simulator.initialize()) {
+        return optimized;
+    }
+    simulator.setRelayFeedback(RELAY_AMPLITUDE, RELAY_HYSTERESIS);
+
+    std::vector<float> errors;
+    errors.reserve(static_cast<size_t>(RELAY_MAX_TIME / SIMULATION_DT));
+    while (!simulator.isComplete() && !simulator.hasFailed() &&
+           simulator.getCurrentState().time < RELAY_MAX_TIME) {
+        simulator.step(SIMULATION_DT);
+        errors.push_back(simulator.getCurrentState().lineError);
+    }
+
+    RelayCycle cycle;
+    if (!analyzeRelay(errors, SIMULATION_DT, cycle)) {
+        return optimized;
+    }
+
+    float ku = cycle.ultimateGain;
+    float tu = cycle.ultimatePeriod;
+    float kp;
+    float ti;
+    float td;
+
+    if (rule == TuningRule::TYREUS_LUYBEN) {
+        kp = ku / 2.2f;
+        ti = 2.2f * tu;
+        td = tu / 6.3f;
+    } else if (rule == TuningRule::COHEN_COON) {
+        // First order plus dead time K e^(-theta s) / (tau s + 1) through the
+        // cycle: phase -pi at the cycle frequency, gain 1/Ku there
+        float omega = 2.0f * Physics::PI / tu;
+        float phase = Physics::clamp(omega * cycle.deadTime,
+                                     0.5f * Physics::PI + PHASE_MARGIN, Physics::PI - PHASE_MARGIN);
+        float theta = phase / omega;
+        float tau = std::tan(Physics::PI - phase) / omega;
+        float gain = std::sqrt(1.0f + omega * omega * tau * tau) / ku;
+        float r = theta / tau;
+
+        kp = (1.0f / (gain * r)) * (4.0f / 3.0f + 0.25f * r);
+        ti = theta * (32.0f + 6.0f * r) / (13.0f + 8.0f * r);
+        td = theta * 4.0f / (11.0f + 2.0f * r);
+    } else {
+        kp = 0.6f * ku;
+        ti = 0.5f * tu;
+        td = 0.125f * tu;
+    }
+
+    // Parallel form used by the simulator: P + ki * integral + kd * derivative
+    optimized.kp = kp;
+    optimized.ki = kp / ti;
+    optimized.kd = kp * td;
     return optimized;
 }
 
@@ -45,12 +696,34 @@ void Optimizer::cancel() {
     cancelled_ = true;
 }
 
+void Optimizer::setRobust(int scenarioCount, float frictionSpread, float temperatureSpread,
+                          RobustObjective objective, float cvarAlpha)
+{
+    params_.scenarioCount = scenarioCount;
+    params_.frictionSpread = frictionSpread;
+    params_.temperatureSpread = temperatureSpread;
+    params_.robustObjective = objective;
+    params_.cvarAlpha = cvarAlpha;
+}
+
+bool Optimizer::stopRequested() const {
+    if (cancelled_) {
+        return true;
+    }
+    return params_.timeBudget > 0.0f && std::chrono::steady_clock::now() >= deadline_;
+}
+
 float Optimizer::evaluateFitness(
     const RobotConfig& config,
-    const std::vector<TrackPoint>& trackPoints)
+    const std::shared_ptr<const CompiledTrack>& track)
 {
-    SimulationMetrics metrics = runSimulation(config, trackPoints);
+    return calculateFitness(evaluatePopulation({config}, track)[0]);
+}
 
+float Optimizer::calculateFitness(const SimulationMetrics& metrics) {
+    if (metrics.scenarioFitness >= 0.0f) {
+        return metrics.scenarioFitness;
+    }
     if (!metrics.completed) {
         return 0.0f;
     }
@@ -59,77 +732,1054 @@ float Optimizer::evaluateFitness(
     float timeFitness = 1.0f / (1.0f + metrics.completionTime);
     float errorFitness = 1.0f / (1.0f + metrics.trackErrors);
 
-    return 0.7f * timeFitness + 0.3f * errorFitness;
+    return FITNESS_TIME_WEIGHT * timeFitness + FITNESS_ERROR_WEIGHT * errorFitness;
+}
+
+float Optimizer::fitnessCutoff(float bestFitness) const {
+    // A scenario average can still win after one slow scenario
+    if (!scenarios_.empty() && params_.robustObjective != RobustObjective::WORST_CASE) {
+        return 0.0f;
+    }
+    // Even a lap with no tracking error cannot beat bestFitness past this
+    if (bestFitness <= FITNESS_ERROR_WEIGHT) {
+        return 0.0f;
+    }
+    return FITNESS_TIME_WEIGHT / (bestFitness - FITNESS_ERROR_WEIGHT) - 1.0f;
 }
 
-Optimizer::SimulationMetrics Optimizer::runSimulation(
+OptimizationResult Optimizer::makeResult(
     const RobotConfig& config,
-    const std::vector<TrackPoint>& trackPoints)
+    float fitness,
+    const SimulationMetrics& metrics,
+    int iterations,
+    bool converged)
+{
+    OptimizationResult result;
+    result.optimalConfig = config;
+    result.fitnessScore = fitness;
+    result.completionTime = metrics.completionTime;
+    result.averageSpeed = metrics.averageSpeed;
+    result.iterations = iterations;
+    result.converged = converged;
+    return result;
+}
+
+std::vector<Optimizer::SimulationMetrics> Optimizer::evaluatePopulation(
+    const std::vector<RobotConfig>& configs,
+    const std::shared_ptr<const CompiledTrack>& track,
+    float cutoffTime,
+    uint32_t noiseSeed,
+    const Fidelity& fidelity)
+{
+    int count = static_cast<int>(configs.size());
+    int scenarios = static_cast<int>(scenarios_.size());
+    std::vector<SimulationMetrics> results;
+
+    if (scenarios == 0) {
+        results = simulatePopulation(configs, track, cutoffTime, noiseSeed, fidelity);
+    } else {
+        // Every candidate under every scenario as one batch
+        std::vector<SimulationMetrics> runs =
+            simulatePopulation(scenarioVariants(configs), track, cutoffTime, noiseSeed, fidelity);
+
+        float target = fidelity.arcLength > 0.0f ? std::min(fidelity.arcLength, track->length()) : track->length();
+        float share = tailShare(params_.robustObjective);
+        results.resize(count);
+        for (int i = 0; i < count; i++) {
+            results[i] = tailAverage(std::vector<SimulationMetrics>(runs.begin() + i * scenarios,
+                                                                    runs.begin() + (i + 1) * scenarios),
+                                     share, target);
+        }
+    }
+
+    // Stream improvements of the best full lap
+    if (fidelity.arcLength <= 0.0f && fidelity.dt <= 0.0f) {
+        int best = -1;
+        float bestFitness = best_.fitnessScore;
+        for (int i = 0; i < count; i++) {
+            float fitness = calculateFitness(results[i]);
+            if (!results[i].interrupted && fitness > std::max(bestFitness, 0.0f)) {
+                best = i;
+                bestFitness = fitness;
+            }
+        }
+        if (best >= 0) {
+            best_.optimalConfig = configs[best];
+            best_.fitnessScore = bestFitness;
+            best_.completionTime = results[best].completionTime;
+            best_.averageSpeed = results[best].averageSpeed;
+            best_.evaluations = evaluations_;
+            best_.elapsedTime = elapsedBefore_ +
+                std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime_).count();
+            if (bestCallback_) {
+                VelocityProfile profile;
+                profile.compute(*track, VelocityLimits::fromConfig(best_.optimalConfig));
+                best_.lapTimeBound = profile.lapTime();
+                bestCallback_(best_);
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<Optimizer::SimulationMetrics> Optimizer::simulatePopulation(
+    const std::vector<RobotConfig>& configs,
+    const std::shared_ptr<const CompiledTrack>& track,
+    float cutoffTime,
+    uint32_t noiseSeed,
+    const Fidelity& fidelity)
+{
+    int count = static_cast<int>(configs.size());
+    std::vector<SimulationMetrics> results(count);
+    std::vector<uint64_t> keys(count);
+
+    // Answer from the cache; simulate each remaining key once
+    std::vector<int> pending;
+    std::unordered_map<uint64_t, int> firstIndex;
+    for (int i = 0; i < count; i++) {
+        keys[i] = evaluationKey(configs[i], track->hash(), params_.sensorNoise, noiseSeed, cutoffTime, fidelity);
+        if (cache_.capacity() > 0 && cache_.find(keys[i], results[i])) {
+            continue;
+        }
+        if (firstIndex.emplace(keys[i], i).second) {
+            pending.push_back(i);
+        }
+    }
+
+    // Contiguous chunks of the pending runs, each one lockstep batch
+    int pendingCount = static_cast<int>(pending.size());
+    int chunks = std::min(pendingCount, pool_->size() * BATCHES_PER_THREAD);
+    pool_->parallelFor(chunks, [&](int c) {
+        int begin = c * pendingCount / chunks;
+        int end = (c + 1) * pendingCount / chunks;
+        if (stopRequested()) {
+            for (int p = begin; p < end; p++) {
+                results[pending[p]] = SimulationMetrics{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, false, true};
+            }
+            return;
+        }
+
+        std::vector<RobotConfig> batch;
+        for (int p = begin; p < end; p++) {
+            batch.push_back(configs[pending[p]]);
+        }
+        std::vector<SimulationMetrics> metrics = runSimulation(batch, track, cutoffTime, noiseSeed, fidelity);
+        for (int p = begin; p < end; p++) {
+            results[pending[p]] = metrics[p - begin];
+        }
+    });
+
+    for (int i : pending) {
+        if (!results[i].interrupted) {
+            evaluations_++;
+            cache_.insert(keys[i], results[i]);
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        auto first = firstIndex.find(keys[i]);
+        if (first != firstIndex.end() && first->second != i) {
+            results[i] = results[first->second];
+        }
+    }
+    return results;
+}
+
+void Optimizer::sampleScenarios() {
+    scenarios_.clear();
+    int count = params_.scenarioCount;
+    if (count <= 1) {
+        return;
+    }
+
+    // One stratum per scenario in each dimension, paired by independent
+    // shuffles. Raw generator output only, so every platform draws the
+    // same set.
+    std::mt19937 rng(SCENARIO_SEED);
+    auto unit = [&]() { return static_cast<float>(rng()) / 4294967296.0f; };
+    auto shuffled = [&]() {
+        std::vector<int> strata(count);
+        std::iota(strata.begin(), strata.end(), 0);
+        for (int i = count - 1; i > 0; i--) {
+            std::swap(strata[i], strata[rng() % static_cast<uint32_t>(i + 1)]);
+        }
+        return strata;
+    };
+    std::vector<int> friction = shuffled();
+    std::vector<int> temperature = shuffled();
+
+    for (int k = 0; k < count; k++) {
+        float f = (static_cast<float>(friction[k]) + unit()) / static_cast<float>(count);
+        float t = (static_cast<float>(temperature[k]) + unit()) / static_cast<float>(count);
+        scenarios_.push_back(Scenario{params_.frictionSpread * (2.0f * f - 1.0f),
+                                      params_.temperatureSpread * (2.0f * t - 1.0f)});
+    }
+}
+
+std::vector<RobotConfig> Optimizer::scenarioVariants(const std::vector<RobotConfig>& configs) const {
+    std::vector<RobotConfig> variants;
+    variants.reserve(configs.size() * scenarios_.size());
+    for (const RobotConfig& config : configs) {
+        for (const Scenario& scenario : scenarios_) {
+            RobotConfig variant = config;
+            variant.frictionCoeff = std::max(SCENARIO_MIN_FRICTION, config.frictionCoeff * (1.0f + scenario.friction));
+            variant.temperature = config.temperature + scenario.temperature;
+            variants.push_back(variant);
+        }
+    }
+    return variants;
+}
+
+Optimizer::SimulationMetrics Optimizer::tailAverage(std::vector<SimulationMetrics> runs, float share, float target) {
+    // Worst first: failed runs by progress, then finished runs by fitness
+    auto score = [&](const SimulationMetrics& metrics) {
+        return metrics.completed ? calculateFitness(metrics) : -1.0f + metrics.progress / target;
+    };
+    std::stable_sort(runs.begin(), runs.end(), [&](const SimulationMetrics& a, const SimulationMetrics& b) {
+        return score(a) < score(b);
+    });
+
+    int size = static_cast<int>(runs.size());
+    int tail = std::min(size, std::max(1, static_cast<int>(std::ceil(share * size - 1e-3f))));
+
+    // A failed run's time and speed are taken where it was abandoned, so
+    // lap time and speed average the finished runs only
+    SimulationMetrics average{0.0f, 0.0f, 0.0f, 0.0f, runs[0].progress, true, false, 0.0f};
+    int finished = 0;
+    for (int k = 0; k < tail; k++) {
+        average.scenarioFitness += calculateFitness(runs[k]) / tail;
+        if (runs[k].completed) {
+            average.completionTime += runs[k].completionTime;
+            average.averageSpeed += runs[k].averageSpeed;
+            finished++;
+        }
+        average.trackErrors += runs[k].trackErrors / tail;
+        average.energyConsumption += runs[k].energyConsumption / tail;
+        average.progress = std::min(average.progress, runs[k].progress);
+        average.completed = average.completed && runs[k].completed;
+    }
+    if (finished > 0) {
+        average.completionTime /= finished;
+        average.averageSpeed /= finished;
+    }
+    for (const SimulationMetrics& metrics : runs) {
+        average.interrupted = average.interrupted || metrics.interrupted;
+    }
+    return average;
+}
+
+float Optimizer::tailShare(RobustObjective objective) const {
+    switch (objective) {
+        case RobustObjective::WORST_CASE: return 0.0f;
+        case RobustObjective::MEAN: return 1.0f;
+        default: return std::min(std::max(params_.cvarAlpha, 0.0f), 1.0f);
+    }
+}
+
+std::vector<Optimizer::SimulationMetrics> Optimizer::runSimulation(
+    const std::vector<RobotConfig>& configs,
+    const std::shared_ptr<const CompiledTrack>& track,
+    float cutoffTime,
+    uint32_t noiseSeed,
+    const Fidelity& fidelity)
 {
-    // TODO: Run actual simulation
-    SimulationMetrics metrics;
-    metrics.completionTime = 50.0f; // Placeholder
-    metrics.averageSpeed = 0.8f;
-    metrics.trackErrors = 2.0f;
-    metrics.energyConsumption = 100.0f;
-    metrics.completed = true;
+    std::vector<SimulationMetrics> results(configs.size(), SimulationMetrics{0.0f, 0.0f, 0.0f, 0.0f, 0.0f, false, false});
+
+    float dt = fidelity.dt > 0.0f ? fidelity.dt : SIMULATION_DT;
+    float prefix = fidelity.arcLength > 0.0f && fidelity.arcLength < track->length()
+        ? fidelity.arcLength
+        : 0.0f;
+
+    FailureCriteria criteria = FailureCriteria::defaults();
+    criteria.cutoffTime = cutoffTime;
+
+    SimulatorBatch batch(configs, track);
+    batch.setFailureCriteria(criteria);
+    batch.setSensorNoise(params_.sensorNoise, noiseSeed);
+    batch.setFinishDistance(prefix);
+    if (!batch.initialize()) {
+        return results;
+    }
+
+    bool interrupted = false;
+    int steps = 0;
+    while (!batch.isDone()) {
+        if (++steps % STOP_CHECK_STEPS == 0 && stopRequested()) {
+            interrupted = true;
+            break;
+        }
+        batch.step(dt);
+    }
+
+    for (int i = 0; i < batch.size(); i++) {
+        SimulationMetrics& metrics = results[i];
+        if (interrupted && !batch.isComplete(i) && !batch.hasFailed(i)) {
+            metrics.interrupted = true;
+            continue;
+        }
+        float elapsed = batch.getElapsedTime(i);
+        metrics.completed = batch.isComplete(i);
+        metrics.completionTime = metrics.completed ? batch.getCompletionTime(i) : elapsed;
+        metrics.averageSpeed = elapsed > 0.0f ? batch.getDistance(i) / elapsed : 0.0f;
+        metrics.trackErrors = elapsed > 0.0f ? batch.getTrackError(i) / elapsed : 0.0f;
+        metrics.energyConsumption = batch.getEnergy(i);
+        metrics.progress = metrics.completed && prefix <= 0.0f ? track->length() : batch.getProgress(i);
+    }
 
-    return metrics;
+    return results;
 }
 
 OptimizationResult Optimizer::gradientDescent(
     const RobotConfig& initialConfig,
-    const std::vector<TrackPoint>& trackPoints,
+    const std::shared_ptr<const CompiledTrack>& track,
     std::function<void(float)> progressCallback)
 {
-    RobotConfig bestConfig = initialConfig;
-    float bestFitness = evaluateFitness(bestConfig, trackPoints);
+    // Everything that carries over between iterations, saved as one block
+    struct State {
+        int32_t iteration;       // iterations completed
+        bool converged;
+        RobotConfig bestConfig;
+        SimulationMetrics bestMetrics;
+        float bestFitness;
+    };
+
+    State state;
+    if (resume_) {
+        if (!resume_->read(state)) {
+            resumeFailed_ = true;
+            return OptimizationResult();
+        }
+    } else {
+        state.iteration = 0;
+        state.converged = false;
+        state.bestConfig = initialConfig;
+        state.bestMetrics = evaluatePopulation({state.bestConfig}, track)[0];
+        state.bestFitness = calculateFitness(state.bestMetrics);
+    }
+    auto writeState = [&](CheckpointWriter& out) { out.write(state); };
+
+    int parameters = params_.tuneSpeed ? 4 : 3;
+    int candidates = std::max(1, params_.populationSize);
+    bool interrupted = false;
+
+    while (!state.converged && state.iteration < params_.maxIterations && !stopRequested()) {
+        int iter = state.iteration;
 
-    for (int iter = 0; iter < params_.maxIterations && !cancelled_; iter++) {
         // Report progress
         if (progressCallback) {
             float progress = 100.0f * iter / params_.maxIterations;
             progressCallback(progress);
         }
+        uint32_t seed = static_cast<uint32_t>(iter + 1);
+
+        // A stop mid-iteration discards it, including its step adaptation
+        std::vector<float> steps = gradientSteps_;
 
         // Calculate gradient
-        std::vector<float> gradient = calculateGradient(bestConfig, trackPoints);
+        std::vector<float> gradient = calculateGradient(state.bestConfig, track, seed);
+        if (stopRequested()) {
+            gradientSteps_ = steps;
+            interrupted = true;
+            break;
+        }
 
-        // Update configuration
-        bestConfig.kp += params_.learningRate * gradient[0];
-        bestConfig.ki += params_.learningRate * gradient[1];
-        bestConfig.kd += params_.learningRate * gradient[2];
+        // Ascent direction in relative units, so gains of different
+        // magnitude move by comparable fractions
+        std::vector<float> scale(parameters);
+        std::vector<float> direction(parameters);
+        float norm = 0.0f;
+        for (int i = 0; i < parameters; i++) {
+            scale[i] = parameterScale(state.bestConfig, i);
+            direction[i] = gradient[i] * scale[i];
+            norm += direction[i] * direction[i];
+        }
+        norm = std::sqrt(norm);
+        if (norm <= 0.0f) {
+            state.iteration++;
+            state.converged = true;
+            break;
+        }
+
+        // Parallel line search: candidate 0 is the current point under this
+        // iteration's noise; the others move geometrically from
+        // learningRate up to 100% of each parameter's scale
+        std::vector<RobotConfig> population(candidates + 1, state.bestConfig);
+        float firstStep = Physics::clamp(params_.learningRate, MIN_LEARNING_RATE, 1.0f);
+        for (int k = 1; k <= candidates; k++) {
+            float fraction = candidates > 1 ? static_cast<float>(k - 1) / static_cast<float>(candidates - 1) : 0.0f;
+            float step = firstStep * std::pow(1.0f / firstStep, fraction);
+            for (int i = 0; i < parameters; i++) {
+                float& value = parameter(population[k], i);
+                value = std::max(PARAMETER_MIN[i], value + step * scale[i] * direction[i] / norm);
+            }
+        }
 
-        // Evaluate new fitness
-        float fitness = evaluateFitness(bestConfig, trackPoints);
+        std::vector<SimulationMetrics> metrics =
+            evaluatePopulation(population, track, fitnessCutoff(state.bestFitness), seed);
+        if (stopRequested()) {
+            gradientSteps_ = steps;
+            interrupted = true;
+            break;
+        }
+        state.iteration++;
+
+        int best = 0;
+        for (int k = 1; k <= candidates; k++) {
+            if (calculateFitness(metrics[k]) > calculateFitness(metrics[best])) {
+                best = k;
+            }
+        }
 
-        if (fitness > bestFitness) {
-            bestFitness = fitness;
+        float current = calculateFitness(metrics[0]);
+        float fitness = calculateFitness(metrics[best]);
+        if (best > 0 && fitness > current + params_.tolerance * current) {
+            state.bestConfig = population[best];
+            state.bestMetrics = metrics[best];
+            state.bestFitness = fitness;
         } else {
-            break; // Converged
+            state.converged = true;
         }
+        checkpoint(writeState, false);
+    }
+    if (interrupted || stopRequested()) {
+        checkpoint(writeState, true);
     }
 
-    // Build result
-    OptimizationResult result;
-    result.optimalConfig = bestConfig;
-    result.fitnessScore = bestFitness;
-    result.completionTime = 50.0f; // TODO: Get from simulation
-    result.averageSpeed = 0.8f;
-    result.iterations = params_.maxIterations;
-    result.converged = true;
+    OptimizationResult result = makeResult(state.bestConfig, state.bestFitness, state.bestMetrics,
+                                           state.iteration, state.converged);
     result.strategy = "Gradient Descent (Phase 1)";
 
     return result;
 }
 
+OptimizationResult Optimizer::cmaEs(
+    const RobotConfig& initialConfig,
+    const std::shared_ptr<const CompiledTrack>& track,
+    std::function<void(float)> progressCallback)
+{
+    int parameters = params_.tuneSpeed ? 4 : 3;
+
+    // Search in units of each parameter's initial magnitude
+    std::vector<float> scale(parameters);
+    Eigen::VectorXd start(parameters);
+    for (int i = 0; i < parameters; i++) {
+        scale[i] = parameterScale(initialConfig, i);
+        start[i] = parameter(initialConfig, i) / scale[i];
+    }
+
+    int defaultLambda = params_.populationSize > 0
+        ? params_.populationSize
+        : 4 + static_cast<int>(3.0 * std::log(static_cast<double>(parameters)));
+    int maxRestarts = params_.restartPolicy == RestartPolicy::NONE ? 0 : params_.maxRestarts;
+
+    // Restart bookkeeping, saved as one block with the restart RNG and,
+    // inside a run, the CMA-ES state
+    struct State {
+        int32_t run;
+        int32_t generations;
+        int32_t restarts;
+        int32_t largeLambda;
+        int64_t largeBudget;     // evaluations spent in each BIPOP regime
+        int64_t smallBudget;
+        int32_t lambda;          // current run
+        double sigma;
+        bool smallRegime;
+        bool inRun;
+        bool converged;
+        RobotConfig bestConfig;
+        SimulationMetrics bestMetrics;
+        float bestFitness;
+    };
+
+    State state;
+    std::mt19937 restartRng(CMA_RESTART_SEED);
+    std::unique_ptr<Optimizers::CMAES> cma;
+
+    if (resume_) {
+        bool resumed = resume_->read(state) && resume_->read(restartRng);
+        if (resumed && state.inRun) {
+            cma = std::make_unique<Optimizers::CMAES>(start, state.sigma, state.lambda,
+                                                      static_cast<uint32_t>(state.run + 1));
+            resumed = cma->restore(*resume_);
+        }
+        if (!resumed) {
+            resumeFailed_ = true;
+            return OptimizationResult();
+        }
+    } else {
+        state = State{0, 0, 0, defaultLambda, 0, 0, defaultLambda, params_.sigma, false, false, false,
+                      initialConfig, SimulationMetrics(), 0.0f};
+        state.bestMetrics = evaluatePopulation({state.bestConfig}, track)[0];
+        state.bestFitness = calculateFitness(state.bestMetrics);
+    }
+
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+    // Last state between generations, which is what a checkpoint records
+    State saved = state;
+    std::mt19937 savedRng = restartRng;
+    std::unique_ptr<Optimizers::CMAES> savedCma = cma ? std::make_unique<Optimizers::CMAES>(*cma) : nullptr;
+    auto writeState = [&](CheckpointWriter& out) {
+        out.write(saved);
+        out.write(savedRng);
+        if (saved.inRun) {
+            savedCma->save(out);
+        }
+    };
+
+    std::vector<RobotConfig> population;
+    std::vector<double> costs;
+
+    while (!stopRequested()) {
+        if (!state.inRun) {
+            if (state.run > maxRestarts || state.generations >= params_.maxIterations) {
+                break;
+            }
+
+            // Population and step size for this run
+            state.lambda = state.largeLambda;
+            state.sigma = params_.sigma;
+            state.smallRegime = false;
+            if (state.run > 0) {
+                if (params_.restartPolicy == RestartPolicy::BIPOP && state.run > 1 && state.smallBudget < state.largeBudget) {
+                    double u = uniform(restartRng);
+                    state.lambda = std::max(2, static_cast<int>(
+                        defaultLambda * std::pow(0.5 * state.largeLambda / defaultLambda, u * u)));
+                    state.sigma = params_.sigma * std::pow(10.0, -2.0 * u);
+                    state.smallRegime = true;
+                } else {
+                    state.largeLambda *= 2;
+                    state.lambda = state.largeLambda;
+                }
+                state.restarts++;
+            }
+
+            cma = std::make_unique<Optimizers::CMAES>(start, state.sigma, state.lambda,
+                                                      static_cast<uint32_t>(state.run + 1));
+            state.inRun = true;
+            state.converged = false;
+        }
+
+        if (progressCallback) {
+            progressCallback(100.0f * state.generations / params_.maxIterations);
+        }
+
+        // Decode candidates; negative parameters are clamped and penalized
+        const std::vector<Eigen::VectorXd>& samples = cma->ask();
+        population.assign(cma->lambda(), initialConfig);
+        costs.assign(cma->lambda(), 0.0);
+        std::vector<double> penalty(cma->lambda(), 0.0);
+        for (int k = 0; k < cma->lambda(); k++) {
+            for (int i = 0; i < parameters; i++) {
+                double x = samples[k][i];
+                double clamped = std::max(x, static_cast<double>(PARAMETER_MIN[i]) / scale[i]);
+                penalty[k] += (x - clamped) * (x - clamped);
+                parameter(population[k], i) = static_cast<float>(clamped) * scale[i];
+            }
+        }
+
+        // One parallel batch per generation, common noise for the ranking
+        std::vector<SimulationMetrics> metrics =
+            evaluatePopulation(population, track, fitnessCutoff(state.bestFitness), static_cast<uint32_t>(state.generations + 1));
+        if (stopRequested()) {
+            break;
+        }
+        state.generations++;
+        for (int k = 0; k < cma->lambda(); k++) {
+            float fitness = calculateFitness(metrics[k]);
+            costs[k] = -fitness + penalty[k];
+            if (fitness > state.bestFitness) {
+                state.bestFitness = fitness;
+                state.bestConfig = population[k];
+                state.bestMetrics = metrics[k];
+            }
+        }
+        cma->tell(costs);
+
+        if (cma->shouldStop(params_.tolerance, params_.tolerance)) {
+            state.converged = true;
+        }
+        if (state.converged || state.generations >= params_.maxIterations) {
+            int64_t spent = static_cast<int64_t>(cma->generation()) * cma->lambda();
+            if (state.smallRegime) {
+                state.smallBudget += spent;
+            } else {
+                state.largeBudget += spent;
+            }
+            state.run++;
+            state.inRun = false;
+        }
+
+        saved = state;
+        savedRng = restartRng;
+        savedCma = state.inRun ? std::make_unique<Optimizers::CMAES>(*cma) : nullptr;
+        checkpoint(writeState, false);
+    }
+    if (stopRequested()) {
+        checkpoint(writeState, true);
+    }
+
+    if (progressCallback) {
+        progressCallback(100.0f);
+    }
+
+    OptimizationResult result = makeResult(state.bestConfig, state.bestFitness, state.bestMetrics,
+                                           state.generations, state.converged);
+    switch (params_.restartPolicy) {
+        case RestartPolicy::IPOP: result.strategy = "CMA-ES (IPOP)"; break;
+        case RestartPolicy::BIPOP: result.strategy = "CMA-ES (BIPOP)"; break;
+        default: result.strategy = "CMA-ES"; break;
+    }
+    if (state.restarts > 0) {
+        result.strategy += ", " + std::to_string(state.restarts) + " restarts";
+    }
+
+    return result;
+}
+
+OptimizationResult Optimizer::lbfgs(
+    const RobotConfig& initialConfig,
+    const std::shared_ptr<const CompiledTrack>& track,
+    std::function<void(float)> progressCallback)
+{
+    int parameters = params_.tuneSpeed ? 4 : 3;
+
+    // Same relative coordinates as cmaEs
+    std::vector<float> scale(parameters);
+    for (int i = 0; i < parameters; i++) {
+        scale[i] = parameterScale(initialConfig, i);
+    }
+
+    // Only the best point survives a checkpoint; a resumed run restarts
+    // the quasi-Newton memory from there
+    struct State {
+        int32_t iterations;
+        RobotConfig bestConfig;
+        SimulationMetrics bestMetrics;
+        float bestFitness;
+    };
+
+    State state;
+    if (resume_) {
+        if (!resume_->read(state)) {
+            resumeFailed_ = true;
+            return OptimizationResult();
+        }
+    } else {
+        state.iterations = 0;
+        state.bestConfig = initialConfig;
+        state.bestMetrics = evaluatePopulation({state.bestConfig}, track)[0];
+        state.bestFitness = calculateFitness(state.bestMetrics);
+    }
+    const int previousIterations = state.iterations;
+    auto writeState = [&](CheckpointWriter& out) { out.write(state); };
+
+    Eigen::VectorXd start(parameters);
+    for (int i = 0; i < parameters; i++) {
+        start[i] = parameter(state.bestConfig, i) / scale[i];
+    }
+
+    // Negative fitness; parameters below their bound are clamped and
+    // penalized quadratically so the objective stays smooth
+    const double penaltyWeight = 1.0;
+    Optimizers::LBFGS::Objective objective = [&](const Eigen::VectorXd& x, Eigen::VectorXd& gradient) {
+        RobotConfig config = initialConfig;
+        double penalty = 0.0;
+        for (int i = 0; i < parameters; i++) {
+            double lower = PARAMETER_MIN[i] / scale[i];
+            double excess = std::min(0.0, x[i] - lower);
+            penalty += penaltyWeight * excess * excess;
+            gradient[i] = 2.0 * penaltyWeight * excess;
+            parameter(config, i) = static_cast<float>(std::max(x[i], lower)) * scale[i];
+        }
+
+        SimulationMetrics centre;
+        std::vector<float> fitnessGradient = calculateGradient(config, track, 1, &centre);
+        float fitness = calculateFitness(centre);
+        if (fitness > state.bestFitness) {
+            state.bestFitness = fitness;
+            state.bestConfig = config;
+            state.bestMetrics = centre;
+        }
+
+        for (int i = 0; i < parameters; i++) {
+            gradient[i] -= scale[i] * fitnessGradient[i];
+        }
+        return -fitness + penalty;
+    };
+
+    Optimizers::LBFGSSettings settings = Optimizers::LBFGSSettings::defaults();
+    settings.maxIterations = std::max(0, params_.maxIterations - previousIterations);
+    settings.valueTolerance = params_.tolerance;
+
+    Optimizers::LBFGS solver(settings);
+    Optimizers::LBFGSResult solution = solver.minimize(objective, start, [&](int iteration, double) {
+        state.iterations = previousIterations + iteration;
+        if (progressCallback) {
+            progressCallback(100.0f * state.iterations / params_.maxIterations);
+        }
+        checkpoint(writeState, false);
+        return !stopRequested();
+    });
+    if (stopRequested()) {
+        checkpoint(writeState, true);
+    }
+
+    OptimizationResult result = makeResult(state.bestConfig, state.bestFitness, state.bestMetrics,
+                                           previousIterations + solution.iterations, solution.converged);
+    result.strategy = "L-BFGS, " + std::to_string(solution.evaluations) + " gradient evaluations";
+
+    return result;
+}
+
+OptimizationResult Optimizer::hyperband(
+    const RobotConfig& initialConfig,
+    const std::shared_ptr<const CompiledTrack>& track,
+    std::function<void(float)> progressCallback)
+{
+    int parameters = params_.tuneSpeed ? 4 : 3;
+    int widest = std::max(1, params_.populationSize);
+    float lapLength = track->length();
+
+    // Position in the bracket schedule, saved as one block with the
+    // sampling RNG and the population of the pending rung
+    struct State {
+        int32_t bracket;
+        int32_t rung;
+        int32_t rungs;           // rungs evaluated
+        RobotConfig bestConfig;
+        SimulationMetrics bestMetrics;
+        float bestFitness;
+    };
+
+    State state;
+    std::mt19937 rng(HYPERBAND_SEED);
+    std::vector<RobotConfig> population;
+    if (resume_) {
+        if (!resume_->read(state) || !resume_->read(rng) || !resume_->read(population)) {
+            resumeFailed_ = true;
+            return OptimizationResult();
+        }
+    } else {
+        state.bracket = HYPERBAND_MAX_BRACKET;
+        state.rung = 0;
+        state.rungs = 0;
+        state.bestConfig = initialConfig;
+        state.bestMetrics = evaluatePopulation({state.bestConfig}, track)[0];
+        state.bestFitness = calculateFitness(state.bestMetrics);
+    }
+    auto writeState = [&](CheckpointWriter& out) {
+        out.write(state);
+        out.write(rng);
+        out.write(population);
+    };
+
+    // Candidates: each parameter scaled log-uniformly within 4x of the start
+    std::uniform_real_distribution<float> logFactor(-std::log(4.0f), std::log(4.0f));
+    auto sample = [&]() {
+        RobotConfig config = initialConfig;
+        for (int i = 0; i < parameters; i++) {
+            parameter(config, i) = std::max(PARAMETER_MIN[i], parameterScale(initialConfig, i) * std::exp(logFactor(rng)));
+        }
+        return config;
+    };
+
+    // Rung score: finishers by fitness, the rest by how far they got
+    auto score = [&](const SimulationMetrics& metrics, float target) {
+        return metrics.completed ? calculateFitness(metrics) : -1.0f + metrics.progress / target;
+    };
+
+    int brackets = HYPERBAND_MAX_BRACKET + 1;
+    bool interrupted = false;
+    while (state.bracket >= 0 && state.rungs < params_.maxIterations && !interrupted && !stopRequested()) {
+        int bracket = state.bracket;
+
+        // A bracket starts with no population; a resumed one already has it
+        if (population.empty()) {
+            if (progressCallback) {
+                progressCallback(100.0f * (HYPERBAND_MAX_BRACKET - bracket) / brackets);
+            }
+
+            // Fewer candidates for brackets whose first rung is already long
+            float reduction = static_cast<float>(HYPERBAND_MAX_BRACKET + 1) / static_cast<float>(bracket + 1)
+                * std::pow(static_cast<float>(HYPERBAND_ETA), static_cast<float>(bracket - HYPERBAND_MAX_BRACKET));
+            int count = std::max(1, static_cast<int>(std::ceil(widest * reduction)));
+
+            if (bracket == HYPERBAND_MAX_BRACKET) {
+                population.push_back(initialConfig);
+            }
+            while (static_cast<int>(population.size()) < count) {
+                population.push_back(sample());
+            }
+        }
+
+        // Successive halving: rung r simulates eta^(r - bracket) of the lap
+        for (; state.rung <= bracket; state.rung++) {
+            if (stopRequested() || state.rungs >= params_.maxIterations) {
+                interrupted = true;
+                break;
+            }
+            float fraction = std::pow(static_cast<float>(HYPERBAND_ETA), static_cast<float>(state.rung - bracket));
+            bool fullLap = state.rung == bracket;
+            Fidelity fidelity{fullLap ? 0.0f : fraction * lapLength, fullLap ? 0.0f : PREFIX_DT};
+            float target = fullLap ? lapLength : fidelity.arcLength;
+
+            std::vector<SimulationMetrics> metrics = evaluatePopulation(population, track, 0.0f, 0, fidelity);
+            if (stopRequested()) {
+                interrupted = true;
+                break;
+            }
+            state.rungs++;
+
+            std::vector<int> order(population.size());
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return score(metrics[a], target) > score(metrics[b], target);
+            });
+
+            if (fullLap) {
+                for (int k : order) {
+                    float fitness = calculateFitness(metrics[k]);
+                    if (fitness > state.bestFitness) {
+                        state.bestFitness = fitness;
+                        state.bestConfig = population[k];
+                        state.bestMetrics = metrics[k];
+                    }
+                }
+                break;
+            }
+
+            int keep = std::max(1, static_cast<int>(population.size()) / HYPERBAND_ETA);
+            std::vector<RobotConfig> survivors;
+            for (int k = 0; k < keep; k++) {
+                survivors.push_back(population[order[k]]);
+            }
+            population.swap(survivors);
+
+            // Checkpoint as if the next rung had not started yet
+            state.rung++;
+            checkpoint(writeState, false);
+            state.rung--;
+        }
+        if (interrupted) {
+            break;
+        }
+
+        state.bracket--;
+        state.rung = 0;
+        population.clear();
+        checkpoint(writeState, false);
+    }
+    if (stopRequested()) {
+        checkpoint(writeState, true);
+    }
+
+    if (progressCallback) {
+        progressCallback(100.0f);
+    }
+
+    OptimizationResult result = makeResult(state.bestConfig, state.bestFitness, state.bestMetrics,
+                                           state.rungs, state.bracket < 0);
+    result.strategy = "Hyperband (" + std::to_string(brackets) + " brackets)";
+
+    return result;
+}
+
+OptimizationResult Optimizer::nsga2(
+    const RobotConfig& initialConfig,
+    const std::shared_ptr<const CompiledTrack>& track,
+    std::function<void(float)> progressCallback)
+{
+    int parameters = params_.tuneSpeed ? 4 : 3;
+    float lapLength = track->length();
+
+    // Same relative coordinates as cmaEs, boxed for the variation operators
+    std::vector<float> scale(parameters);
+    Eigen::VectorXd start(parameters);
+    Eigen::VectorXd lower(parameters);
+    Eigen::VectorXd upper(parameters);
+    for (int i = 0; i < parameters; i++) {
+        scale[i] = parameterScale(initialConfig, i);
+        start[i] = parameter(initialConfig, i) / scale[i];
+        lower[i] = PARAMETER_MIN[i] / scale[i];
+        upper[i] = std::max(NSGA2_RANGE, lower[i]);
+    }
+    auto decode = [&](const Eigen::VectorXd& x) {
+        RobotConfig config = initialConfig;
+        for (int i = 0; i < parameters; i++) {
+            parameter(config, i) = static_cast<float>(x[i]) * scale[i];
+        }
+        return config;
+    };
+
+    // Best under the usual weighting and the front's stall count, saved as
+    // one block with the parents
+    struct State {
+        RobotConfig bestConfig;
+        SimulationMetrics bestMetrics;
+        float bestFitness;
+        int32_t stalledGenerations;
+    };
+
+    State state;
+    Optimizers::NSGA2 nsga(start, lower, upper, params_.populationSize, NSGA2_SEED);
+    if (resume_) {
+        if (!resume_->read(state) || !nsga.restore(*resume_)) {
+            resumeFailed_ = true;
+            return OptimizationResult();
+        }
+    } else {
+        state.bestConfig = initialConfig;
+        state.bestMetrics = evaluatePopulation({state.bestConfig}, track, 0.0f, NSGA2_NOISE_SEED)[0];
+        state.bestFitness = calculateFitness(state.bestMetrics);
+        state.stalledGenerations = 0;
+    }
+
+    // ask() advances the sampler, so checkpoints record the state after tell()
+    Optimizers::NSGA2 saved = nsga;
+    State savedState = state;
+    auto writeState = [&](CheckpointWriter& out) {
+        out.write(savedState);
+        saved.save(out);
+    };
+
+    std::vector<RobotConfig> population;
+    std::vector<Eigen::VectorXd> objectives;
+    std::vector<double> violations;
+    std::vector<Eigen::VectorXd> previousFront = frontObjectives(nsga);
+
+    while (!stopRequested() && nsga.generation() < params_.maxIterations &&
+           state.stalledGenerations < NSGA2_STALL_GENERATIONS) {
+        if (progressCallback) {
+            progressCallback(100.0f * nsga.generation() / params_.maxIterations);
+        }
+
+        const std::vector<Eigen::VectorXd>& samples = nsga.ask();
+        population.clear();
+        for (const Eigen::VectorXd& x : samples) {
+            population.push_back(decode(x));
+        }
+
+        std::vector<SimulationMetrics> metrics = evaluatePopulation(population, track, 0.0f, NSGA2_NOISE_SEED);
+        if (stopRequested()) {
+            break;
+        }
+
+        // Minimize all three; a failed lap violates by the share it missed
+        objectives.assign(population.size(), Eigen::VectorXd(3));
+        violations.assign(population.size(), 0.0);
+        for (size_t k = 0; k < population.size(); k++) {
+            objectives[k] << metrics[k].completionTime, metrics[k].energyConsumption, metrics[k].trackErrors;
+            if (!metrics[k].completed) {
+                violations[k] = std::max(1e-6, 1.0 - static_cast<double>(metrics[k].progress / lapLength));
+            }
+
+            float fitness = calculateFitness(metrics[k]);
+            if (fitness > state.bestFitness) {
+                state.bestFitness = fitness;
+                state.bestConfig = population[k];
+                state.bestMetrics = metrics[k];
+            }
+        }
+        nsga.tell(objectives, violations);
+
+        std::vector<Eigen::VectorXd> front = frontObjectives(nsga);
+        state.stalledGenerations = frontSettled(previousFront, front, params_.tolerance)
+            ? state.stalledGenerations + 1 : 0;
+        previousFront = front;
+
+        saved = nsga;
+        savedState = state;
+        checkpoint(writeState, false);
+    }
+    if (stopRequested()) {
+        checkpoint(writeState, true);
+    }
+
+    if (progressCallback) {
+        progressCallback(100.0f);
+    }
+
+    // Converged only when the front stopped improving; the generation cap is not
+    OptimizationResult result = makeResult(state.bestConfig, state.bestFitness, state.bestMetrics,
+                                           nsga.generation(),
+                                           state.stalledGenerations >= NSGA2_STALL_GENERATIONS);
+
+    // First front of the last completed generation, duplicates dropped
+    for (int k : saved.front()) {
+        const Eigen::VectorXd& f = saved.objectives()[k];
+        ParetoPoint point{decode(saved.population()[k]),
+                          static_cast<float>(f[0]), static_cast<float>(f[1]), static_cast<float>(f[2])};
+        bool duplicate = std::any_of(result.paretoFront.begin(), result.paretoFront.end(), [&](const ParetoPoint& other) {
+            return other.completionTime == point.completionTime &&
+                   other.energyConsumption == point.energyConsumption &&
+                   other.trackErrors == point.trackErrors;
+        });
+        if (!duplicate) {
+            result.paretoFront.push_back(point);
+        }
+    }
+    std::sort(result.paretoFront.begin(), result.paretoFront.end(), [](const ParetoPoint& a, const ParetoPoint& b) {
+        return a.completionTime < b.completionTime;
+    });
+    result.strategy = "NSGA-II, " + std::to_string(result.paretoFront.size()) + " Pareto-optimal configurations";
+
+    return result;
+}
+
 std::vector<float> Optimizer::calculateGradient(
     const RobotConfig& config,
-    const std::vector<TrackPoint>& trackPoints)
+    const std::shared_ptr<const CompiledTrack>& track,
+    uint32_t noiseSeed,
+    SimulationMetrics* centreMetrics)
 {
-    // TODO: Implement numerical gradient calculation
-    // Placeholder: return zero gradient
-    return std::vector<float>{0.0f, 0.0f, 0.0f};
+    int parameters = params_.tuneSpeed ? 4 : 3;
+    if (static_cast<int>(gradientSteps_.size()) != parameters) {
+        gradientSteps_.resize(parameters);
+        for (int i = 0; i < parameters; i++) {
+            gradientSteps_[i] = std::max(GRADIENT_MIN_STEP[i], GRADIENT_RELATIVE_STEP * std::abs(parameter(config, i)));
+        }
+    }
+
+    // Centre run followed by +h / -h pairs. Parameters within h of their
+    // lower bound take a forward difference; their -h slot repeats the
+    // centre, which evaluatePopulation simulates only once.
+    std::vector<RobotConfig> population(2 * parameters + 1, config);
+    std::vector<bool> forward(parameters);
+    for (int i = 0; i < parameters; i++) {
+        forward[i] = parameter(config, i) - gradientSteps_[i] < PARAMETER_MIN[i];
+        parameter(population[2 * i + 1], i) += gradientSteps_[i];
+        if (!forward[i]) {
+            parameter(population[2 * i + 2], i) -= gradientSteps_[i];
+        }
+    }
+
+    std::vector<SimulationMetrics> metrics = evaluatePopulation(population, track, 0.0f, noiseSeed);
+    float centre = calculateFitness(metrics[0]);
+    if (centreMetrics) {
+        *centreMetrics = metrics[0];
+    }
+
+    std::vector<float> gradient(parameters);
+    for (int i = 0; i < parameters; i++) {
+        float h = gradientSteps_[i];
+        float plus = calculateFitness(metrics[2 * i + 1]);
+        float minus = calculateFitness(metrics[2 * i + 2]);
+        gradient[i] = forward[i] ? (plus - centre) / h : (plus - minus) / (2.0f * h);
+
+        // Adapt the step for the next call
+        float difference = std::abs(plus - minus);
+        float curvature = std::abs(plus - 2.0f * centre + minus);
+        bool sideFailed = centre > 0.0f && (!metrics[2 * i + 1].completed || !metrics[2 * i + 2].completed);
+        if (sideFailed || curvature > difference) {
+            h *= 0.5f;
+        } else if (difference < GRADIENT_RESOLUTION) {
+            h *= 2.0f;
+        }
+        float maxStep = std::max(GRADIENT_MIN_STEP[i], GRADIENT_MAX_RELATIVE_STEP * std::abs(parameter(config, i)));
+        gradientSteps_[i] = Physics::clamp(h, GRADIENT_MIN_STEP[i], maxStep);
+    }
+
+    return gradient;
 }
 
 } // namespace LineFollower
@@ -0,0 +1,204 @@
+/**
+ * @file cma_es.cpp
+ * @brief Implementation of CMA-ES
+ */
+
+#include "../../include/optimizers/cma_es.hpp"
+#include "../../include/checkpoint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace LineFollower {
+namespace Optimizers {
+
+namespace {
+
+// Generations of best costs considered by the flat-fitness test
+constexpr int HISTORY_LENGTH = 10;
+
+// Restart once the covariance becomes this ill-conditioned
+constexpr double MAX_CONDITION = 1e14;
+
+} // namespace
+
+CMAES::CMAES(const Eigen::VectorXd& mean, double sigma, int lambda, uint32_t seed)
+    : n_(static_cast<int>(mean.size()))
+    , mean_(mean)
+    , sigma_(sigma)
+    , generation_(0)
+    , rng_(seed)
+{
+    double n = static_cast<double>(n_);
+    lambda_ = lambda > 0 ? lambda : 4 + static_cast<int>(3.0 * std::log(n));
+    lambda_ = std::max(lambda_, 2);
+    mu_ = lambda_ / 2;
+
+    // Log-linear recombination weights
+    weights_.resize(mu_);
+    for (int i = 0; i < mu_; i++) {
+        weights_[i] = std::log(0.5 * lambda_ + 0.5) - std::log(i + 1.0);
+    }
+    weights_ /= weights_.sum();
+    mueff_ = 1.0 / weights_.squaredNorm();
+
+    cc_ = (4.0 + mueff_ / n) / (n + 4.0 + 2.0 * mueff_ / n);
+    cs_ = (mueff_ + 2.0) / (n + mueff_ + 5.0);
+    c1_ = 2.0 / ((n + 1.3) * (n + 1.3) + mueff_);
+    cmu_ = std::min(1.0 - c1_, 2.0 * (mueff_ - 2.0 + 1.0 / mueff_) / ((n + 2.0) * (n + 2.0) + mueff_));
+    damps_ = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff_ - 1.0) / (n + 1.0)) - 1.0) + cs_;
+    chiN_ = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+    C_ = Eigen::MatrixXd::Identity(n_, n_);
+    pc_ = Eigen::VectorXd::Zero(n_);
+    ps_ = Eigen::VectorXd::Zero(n_);
+    decompose();
+
+    samples_.resize(lambda_, Eigen::VectorXd(n_));
+}
+
+const std::vector<Eigen::VectorXd>& CMAES::ask() {
+    std::normal_distribution<double> normal(0.0, 1.0);
+    Eigen::VectorXd z(n_);
+    for (Eigen::VectorXd& sample : samples_) {
+        for (int i = 0; i < n_; i++) {
+            z[i] = normal(rng_);
+        }
+        sample = mean_ + sigma_ * (B_ * D_.cwiseProduct(z));
+    }
+    return samples_;
+}
+
+void CMAES::tell(const std::vector<double>& costs) {
+    std::vector<int> order(lambda_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return costs[a] < costs[b]; });
+
+    bestHistory_.push_back(costs[order[0]]);
+    if (static_cast<int>(bestHistory_.size()) > HISTORY_LENGTH) {
+        bestHistory_.erase(bestHistory_.begin());
+    }
+
+    // Recombination
+    Eigen::VectorXd oldMean = mean_;
+    mean_.setZero();
+    for (int i = 0; i < mu_; i++) {
+        mean_ += weights_[i] * samples_[order[i]];
+    }
+    Eigen::VectorXd meanStep = (mean_ - oldMean) / sigma_;
+
+    // Evolution paths
+    generation_++;
+    ps_ = (1.0 - cs_) * ps_ + std::sqrt(cs_ * (2.0 - cs_) * mueff_) * (invSqrtC_ * meanStep);
+    double psNorm = ps_.norm() / std::sqrt(1.0 - std::pow(1.0 - cs_, 2.0 * generation_));
+    bool hsig = psNorm / chiN_ < 1.4 + 2.0 / (n_ + 1.0);
+    pc_ = (1.0 - cc_) * pc_;
+    if (hsig) {
+        pc_ += std::sqrt(cc_ * (2.0 - cc_) * mueff_) * meanStep;
+    }
+
+    // Covariance: rank-one plus rank-mu update
+    Eigen::MatrixXd rankMu = Eigen::MatrixXd::Zero(n_, n_);
+    for (int i = 0; i < mu_; i++) {
+        Eigen::VectorXd y = (samples_[order[i]] - oldMean) / sigma_;
+        rankMu += weights_[i] * y * y.transpose();
+    }
+    double lostVariance = hsig ? 0.0 : cc_ * (2.0 - cc_);
+    C_ = (1.0 - c1_ - cmu_) * C_
+        + c1_ * (pc_ * pc_.transpose() + lostVariance * C_)
+        + cmu_ * rankMu;
+
+    // Step size
+    sigma_ *= std::exp((cs_ / damps_) * (ps_.norm() / chiN_ - 1.0));
+
+    decompose();
+}
+
+bool CMAES::shouldStop(double tolX, double tolFun) const {
+    if (generation_ == 0) {
+        return false;
+    }
+
+    // Every coordinate's search width below tolX
+    bool small = sigma_ * pc_.cwiseAbs().maxCoeff() < tolX;
+    for (int i = 0; i < n_ && small; i++) {
+        small = sigma_ * std::sqrt(C_(i, i)) < tolX;
+    }
+    if (small) {
+        return true;
+    }
+
+    // Best cost flat over the recent generations
+    if (static_cast<int>(bestHistory_.size()) == HISTORY_LENGTH) {
+        auto range = std::minmax_element(bestHistory_.begin(), bestHistory_.end());
+        if (*range.second - *range.first < tolFun) {
+            return true;
+        }
+    }
+
+    double maxD = D_.maxCoeff();
+    double minD = D_.minCoeff();
+    return minD <= 0.0 || (maxD * maxD) / (minD * minD) > MAX_CONDITION;
+}
+
+void CMAES::save(CheckpointWriter& out) const {
+    out.write(static_cast<int32_t>(n_));
+    out.write(static_cast<int32_t>(lambda_));
+    out.write(static_cast<int32_t>(generation_));
+    out.write(sigma_);
+    out.write(mean_);
+    out.write(C_);
+    out.write(pc_);
+    out.write(ps_);
+    out.write(bestHistory_);
+    out.write(rng_);
+}
+
+bool CMAES::restore(CheckpointReader& in) {
+    int32_t n = 0;
+    int32_t lambda = 0;
+    int32_t generation = 0;
+    in.read(n);
+    in.read(lambda);
+    in.read(generation);
+    if (!in.ok() || n != n_ || lambda != lambda_) {
+        return false;
+    }
+
+    Eigen::VectorXd mean;
+    Eigen::MatrixXd C;
+    Eigen::VectorXd pc;
+    Eigen::VectorXd ps;
+    double sigma = 0.0;
+    in.read(sigma);
+    in.read(mean);
+    in.read(C);
+    in.read(pc);
+    in.read(ps);
+    in.read(bestHistory_);
+    in.read(rng_);
+    if (!in.ok() || mean.size() != n_ || C.rows() != n_ || C.cols() != n_ || pc.size() != n_ || ps.size() != n_) {
+        return false;
+    }
+
+    generation_ = generation;
+    sigma_ = sigma;
+    mean_ = mean;
+    C_ = C;
+    pc_ = pc;
+    ps_ = ps;
+    decompose();
+    return true;
+}
+
+void CMAES::decompose() {
+    // Enforce symmetry against round-off before decomposing
+    C_ = 0.5 * (C_ + C_.transpose());
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> solver(C_);
+    B_ = solver.eigenvectors();
+    D_ = solver.eigenvalues().cwiseMax(1e-20).cwiseSqrt();
+    invSqrtC_ = B_ * D_.cwiseInverse().asDiagonal() * B_.transpose();
+}
+
+} // namespace Optimizers
+} // namespace LineFollower
@@ -0,0 +1,393 @@
+/**
+ * @file direct_collocation.cpp
+ * @brief Implementation of the minimum-time collocation solver
+ */
+
+#include "../../include/optimizers/direct_collocation.hpp"
+#include "../../include/velocity_profile.hpp"
+#include <Eigen/Sparse>
+#include <algorithm>
+#include <cmath>
+
+namespace LineFollower {
+namespace Optimizers {
+
+namespace {
+
+// Barrier parameter growth between stages
+constexpr double BARRIER_GROWTH = 10.0;
+
+// Newton decrement (lambda^2 / 2) ending a barrier stage
+constexpr double NEWTON_TOLERANCE = 1e-10;
+
+// Armijo constant and shortest step of the backtracking line search
+constexpr double ARMIJO = 0.25;
+constexpr double MIN_STEP = 1e-12;
+
+// Warm start shrink factor and attempts until strictly feasible
+constexpr double WARM_START_SHRINK = 0.9;
+constexpr int MAX_SHRINK_STEPS = 100;
+
+// Warm start kept this far inside the node speed caps
+constexpr double CAP_MARGIN = 0.98;
+
+// Floor of sqrt(b) when linearizing the motor limit (m/s)
+constexpr double MIN_LINEARIZATION_SPEED = 1e-3;
+
+/**
+ * @brief Barrier formulation over b = v^2 at the nodes
+ *
+ * Every constraint couples at most two neighbouring nodes, so gradient
+ * and Hessian of the barrier function are kept as a vector and the
+ * diagonal/off-diagonal of a tridiagonal matrix.
+ */
+class SpeedProblem {
+public:
+    int nodes;
+    double ds;
+    bool fixedStart;             // node 0 pinned at zero (start from rest)
+    std::vector<double> kappa;   // |curvature| per node
+    std::vector<double> cap;     // b upper bound per node
+    std::vector<double> outer;   // outer wheel speed over centre speed
+    double acceleration;         // motor stall acceleration
+    double deceleration;         // braking limit
+    double grip;                 // mu g
+    double topSpeed;
+    std::vector<double> motorPoint;   // sqrt(b) the motor limit is linearized at
+
+    bool variable(int i) const { return i > 0 || !fixedStart; }
+
+    int constraintCount() const {
+        int variables = fixedStart ? nodes - 1 : nodes;
+        return 2 * variables + 4 * (nodes - 1);
+    }
+
+    /**
+     * @brief Relinearize the concave motor limit at b (tangent of sqrt is
+     *        above it, so the linearized constraint is conservative)
+     */
+    void linearize(const Eigen::VectorXd& b) {
+        motorPoint.resize(nodes);
+        for (int i = 0; i < nodes; i++) {
+            motorPoint[i] = std::max(std::sqrt(std::max(b[i], 0.0)), MIN_LINEARIZATION_SPEED);
+        }
+    }
+
+    /**
+     * @brief Traversal time with constant acceleration between nodes
+     */
+    double time(const Eigen::VectorXd& b) const {
+        double total = 0.0;
+        for (int k = 0; k + 1 < nodes; k++) {
+            double sum = std::sqrt(std::max(b[k], 0.0)) + std::sqrt(std::max(b[k + 1], 0.0));
+            total += sum > 0.0 ? 2.0 * ds / sum : 0.0;
+        }
+        return total;
+    }
+
+    /**
+     * @brief Barrier function t * time - sum log(-g)
+     * @return false if b is not strictly feasible
+     */
+    bool evaluate(
+        const Eigen::VectorXd& b,
+        double t,
+        double& value,
+        Eigen::VectorXd* gradient,
+        Eigen::VectorXd* diagonal,
+        Eigen::VectorXd* offDiagonal) const
+    {
+        value = 0.0;
+        bool derivatives = gradient != nullptr;
+        if (derivatives) {
+            gradient->setZero(nodes);
+            diagonal->setZero(nodes);
+            offDiagonal->setZero(nodes - 1);
+        }
+
+        auto node = [&](int i, double g, double gi) {
+            if (!(g < 0.0)) {
+                return false;
+            }
+            value -= std::log(-g);
+            if (derivatives) {
+                (*gradient)[i] -= gi / g;
+                (*diagonal)[i] += gi * gi / (g * g);
+            }
+            return true;
+        };
+
+        auto pair = [&](int k, double g, double gk, double gk1, double hkk, double hkk1, double hk1k1) {
+            if (!(g < 0.0)) {
+                return false;
+            }
+            value -= std::log(-g);
+            if (derivatives) {
+                double w = -1.0 / g;
+                (*gradient)[k] += gk * w;
+                (*gradient)[k + 1] += gk1 * w;
+                (*diagonal)[k] += gk * gk * w * w + hkk * w;
+                (*diagonal)[k + 1] += gk1 * gk1 * w * w + hk1k1 * w;
+                (*offDiagonal)[k] += gk * gk1 * w * w + hkk1 * w;
+            }
+            return true;
+        };
+
+        for (int i = 0; i < nodes; i++) {
+            if (!variable(i)) {
+                continue;
+            }
+            if (!node(i, -b[i], -1.0) || !node(i, b[i] - cap[i], 1.0)) {
+                return false;
+            }
+        }
+
+        double ak = -0.5 / ds;
+        double ak1 = 0.5 / ds;
+        for (int k = 0; k + 1 < nodes; k++) {
+            double a = (b[k + 1] - b[k]) / (2.0 * ds);
+
+            // Braking
+            if (!pair(k, -a - deceleration, -ak, -ak1, 0.0, 0.0, 0.0)) {
+                return false;
+            }
+
+            // Friction circle at both ends of the interval
+            double lateral = kappa[k] * b[k];
+            if (!pair(k, a * a + lateral * lateral - grip * grip,
+                      2.0 * a * ak + 2.0 * kappa[k] * lateral, 2.0 * a * ak1,
+                      2.0 * ak * ak + 2.0 * kappa[k] * kappa[k], 2.0 * ak * ak1, 2.0 * ak1 * ak1)) {
+                return false;
+            }
+            lateral = kappa[k + 1] * b[k + 1];
+            if (!pair(k, a * a + lateral * lateral - grip * grip,
+                      2.0 * a * ak, 2.0 * a * ak1 + 2.0 * kappa[k + 1] * lateral,
+                      2.0 * ak * ak, 2.0 * ak * ak1, 2.0 * ak1 * ak1 + 2.0 * kappa[k + 1] * kappa[k + 1])) {
+                return false;
+            }
+
+            // Motor: a <= A (1 - v_outer / V), sqrt(b) on its tangent
+            double m = motorPoint[k];
+            double speed = m + (b[k] - m * m) / (2.0 * m);
+            double slope = acceleration * outer[k] / (2.0 * topSpeed * m);
+            if (!pair(k, a - acceleration * (1.0 - outer[k] * speed / topSpeed), ak + slope, ak1, 0.0, 0.0, 0.0)) {
+                return false;
+            }
+        }
+
+        // Objective
+        for (int k = 0; k + 1 < nodes; k++) {
+            double r0 = std::sqrt(b[k]);
+            double r1 = std::sqrt(b[k + 1]);
+            double sum = r0 + r1;
+            value += t * 2.0 * ds / sum;
+            if (derivatives) {
+                double s2 = sum * sum;
+                double s3 = s2 * sum;
+                if (variable(k)) {
+                    (*gradient)[k] -= t * ds / (s2 * r0);
+                    (*diagonal)[k] += t * ds * (1.0 / (s3 * r0 * r0) + 0.5 / (s2 * r0 * r0 * r0));
+                    (*offDiagonal)[k] += t * ds / (s3 * r0 * r1);
+                }
+                (*gradient)[k + 1] -= t * ds / (s2 * r1);
+                (*diagonal)[k + 1] += t * ds * (1.0 / (s3 * r1 * r1) + 0.5 / (s2 * r1 * r1 * r1));
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace
+
+DirectCollocation::DirectCollocation(const CollocationSettings& settings)
+    : settings_(settings)
+{
+}
+
+CollocationResult DirectCollocation::solve(
+    const std::vector<float>& curvature,
+    float spacing,
+    const RobotConfig& config,
+    float entrySpeed,
+    float exitSpeed) const
+{
+    CollocationResult result;
+    result.spacing = spacing;
+    result.time = 0.0f;
+    result.newtonSteps = 0;
+    result.converged = false;
+
+    int samples = static_cast<int>(curvature.size());
+    if (samples < 2 || spacing <= 0.0f) {
+        return result;
+    }
+
+    // Nodes: the samples, or fewer with each node keeping the largest
+    // curvature of the samples it covers so no peak is missed
+    int nodes = std::min(samples, std::max(settings_.maxNodes, 2));
+    double length = static_cast<double>(spacing) * (samples - 1);
+    double ds = length / (nodes - 1);
+    std::vector<float> nodeCurvature(nodes);
+    for (int i = 0; i < nodes; i++) {
+        int from = static_cast<int>(std::floor((i - 0.5) * ds / spacing));
+        int to = static_cast<int>(std::ceil((i + 0.5) * ds / spacing));
+        from = std::max(from, 0);
+        to = std::min(to, samples - 1);
+        float peak = 0.0f;
+        for (int k = from; k <= to; k++) {
+            peak = std::max(peak, std::abs(curvature[k]));
+        }
+        nodeCurvature[i] = peak;
+    }
+
+    VelocityLimits limits = VelocityLimits::fromConfig(config);
+
+    SpeedProblem problem;
+    problem.nodes = nodes;
+    problem.ds = ds;
+    problem.fixedStart = entrySpeed == 0.0f;
+    problem.acceleration = limits.maxAcceleration;
+    problem.deceleration = limits.maxDeceleration;
+    problem.grip = limits.friction * limits.gravity;
+    problem.topSpeed = limits.maxSpeed;
+    problem.kappa.resize(nodes);
+    problem.cap.resize(nodes);
+    problem.outer.resize(nodes);
+    for (int i = 0; i < nodes; i++) {
+        double k = nodeCurvature[i];
+        problem.kappa[i] = k;
+        problem.outer[i] = 1.0 + 0.5 * config.wheelbase * k;
+        double wheel = limits.maxSpeed / problem.outer[i];
+        problem.cap[i] = wheel * wheel;
+        if (k > 0.0) {
+            problem.cap[i] = std::min(problem.cap[i], problem.grip / k);
+        }
+    }
+    if (entrySpeed > 0.0f) {
+        problem.cap[0] = std::min(problem.cap[0], static_cast<double>(entrySpeed) * entrySpeed);
+    }
+    if (exitSpeed >= 0.0f) {
+        problem.cap[nodes - 1] = std::min(problem.cap[nodes - 1], static_cast<double>(exitSpeed) * exitSpeed);
+    }
+
+    // Warm start: forward-backward profile, pulled inside the caps, then
+    // shrunk until strictly feasible (b -> 0 always is)
+    VelocityProfile profile;
+    profile.compute(nodeCurvature, static_cast<float>(ds), limits, entrySpeed, exitSpeed, false);
+    Eigen::VectorXd b(nodes);
+    for (int i = 0; i < nodes; i++) {
+        double v = profile.speed()[i];
+        b[i] = problem.variable(i) ? std::min(v * v, CAP_MARGIN * problem.cap[i]) : 0.0;
+    }
+    problem.linearize(b);
+    double value;
+    int shrink = 0;
+    while (!problem.evaluate(b, 1.0, value, nullptr, nullptr, nullptr)) {
+        if (++shrink > MAX_SHRINK_STEPS) {
+            return result;
+        }
+        for (int i = 0; i < nodes; i++) {
+            if (problem.variable(i)) {
+                b[i] *= WARM_START_SHRINK;
+            }
+        }
+        problem.linearize(b);
+    }
+
+    int first = problem.fixedStart ? 1 : 0;
+    int variables = nodes - first;
+    double constraints = problem.constraintCount();
+
+    Eigen::VectorXd gradient, diagonal, offDiagonal;
+    Eigen::SparseMatrix<double> hessian(variables, variables);
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(3 * variables);
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver;
+    bool analyzed = false;
+
+    double lapTime = problem.time(b);
+    for (int sqp = 0; sqp < settings_.sqpIterations; sqp++) {
+        problem.linearize(b);
+        double previousTime = lapTime;
+        double t = constraints / std::max(lapTime, 1e-6);
+        bool gapReached = false;
+        bool centred = true;    // every stage of this pass met NEWTON_TOLERANCE
+
+        while (!gapReached) {
+            // Newton on the barrier function at this t
+            bool stageCentred = false;
+            for (int iter = 0; iter < settings_.maxNewton; iter++) {
+                problem.evaluate(b, t, value, &gradient, &diagonal, &offDiagonal);
+
+                triplets.clear();
+                for (int v = 0; v < variables; v++) {
+                    triplets.emplace_back(v, v, diagonal[v + first]);
+                    if (v + 1 < variables) {
+                        triplets.emplace_back(v + 1, v, offDiagonal[v + first]);
+                        triplets.emplace_back(v, v + 1, offDiagonal[v + first]);
+                    }
+                }
+                hessian.setFromTriplets(triplets.begin(), triplets.end());
+                if (!analyzed) {
+                    solver.analyzePattern(hessian);
+                    analyzed = true;
+                }
+                solver.factorize(hessian);
+                if (solver.info() != Eigen::Success) {
+                    break;
+                }
+                Eigen::VectorXd g = gradient.tail(variables);
+                Eigen::VectorXd step = solver.solve(-g);
+                double decrement = -g.dot(step);
+                result.newtonSteps++;
+                if (decrement * 0.5 < NEWTON_TOLERANCE) {
+                    stageCentred = true;
+                    break;
+                }
+
+                // Backtrack: stay strictly feasible, then sufficient decrease
+                double alpha = 1.0;
+                Eigen::VectorXd trial(nodes);
+                double trialValue;
+                while (alpha > MIN_STEP) {
+                    trial = b;
+                    trial.tail(variables) += alpha * step;
+                    if (problem.evaluate(trial, t, trialValue, nullptr, nullptr, nullptr) &&
+                        trialValue <= value - ARMIJO * alpha * decrement) {
+                        break;
+                    }
+                    alpha *= 0.5;
+                }
+                if (alpha <= MIN_STEP) {
+                    break;
+                }
+                b = trial;
+            }
+            centred = centred && stageCentred;
+
+            lapTime = problem.time(b);
+            gapReached = constraints / t < settings_.gapTolerance * lapTime;
+            t *= BARRIER_GROWTH;
+        }
+
+        // A failed factorization, a collapsed line search or the Newton cap
+        // leaves a stage off the central path; only a pass with every stage
+        // centred and a settled lap time counts
+        bool settled = std::abs(previousTime - lapTime) < settings_.gapTolerance * lapTime;
+        result.converged = centred && settled;
+        if (settled) {
+            break;
+        }
+    }
+
+    result.spacing = static_cast<float>(ds);
+    result.time = static_cast<float>(lapTime);
+    result.speed.resize(nodes);
+    for (int i = 0; i < nodes; i++) {
+        result.speed[i] = static_cast<float>(std::sqrt(std::max(b[i], 0.0)));
+    }
+    return result;
+}
+
+} // namespace Optimizers
+} // namespace LineFollower
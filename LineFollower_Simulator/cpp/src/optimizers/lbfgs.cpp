@@ -0,0 +1,259 @@
+/**
+ * @file lbfgs.cpp
+ * @brief Implementation of L-BFGS with strong Wolfe line search
+ */
+
+#include "../../include/optimizers/lbfgs.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace LineFollower {
+namespace Optimizers {
+
+namespace {
+
+/**
+ * @brief One trial point of the line search
+ */
+struct Trial {
+    double step;
+    double value;
+    double slope;            // directional derivative
+};
+
+/**
+ * @brief Minimizer of the cubic interpolating two trials, kept inside the
+ *        middle 80% of the interval (bisection if the cubic has none)
+ */
+double interpolate(const Trial& a, const Trial& b) {
+    double lo = std::min(a.step, b.step);
+    double hi = std::max(a.step, b.step);
+    double margin = 0.1 * (hi - lo);
+
+    double d1 = a.slope + b.slope - 3.0 * (a.value - b.value) / (a.step - b.step);
+    double radicand = d1 * d1 - a.slope * b.slope;
+    if (radicand >= 0.0) {
+        double d2 = std::copysign(std::sqrt(radicand), b.step - a.step);
+        double denominator = b.slope - a.slope + 2.0 * d2;
+        if (denominator != 0.0) {
+            double step = b.step - (b.step - a.step) * (b.slope + d2 - d1) / denominator;
+            if (std::isfinite(step)) {
+                return std::min(std::max(step, lo + margin), hi - margin);
+            }
+        }
+    }
+    return 0.5 * (lo + hi);
+}
+
+} // namespace
+
+LBFGS::LBFGS(const LBFGSSettings& settings)
+    : settings_(settings)
+{
+}
+
+LBFGSResult LBFGS::minimize(const Objective& objective, const Eigen::VectorXd& start, const Monitor& monitor) {
+    s_.clear();
+    y_.clear();
+
+    LBFGSResult result;
+    result.x = start;
+    result.iterations = 0;
+    result.evaluations = 1;
+    result.converged = false;
+
+    Eigen::VectorXd gradient(start.size());
+    result.value = objective(result.x, gradient);
+
+    for (int iter = 0; iter < settings_.maxIterations; iter++) {
+        if (gradient.cwiseAbs().maxCoeff() < settings_.gradientTolerance) {
+            result.converged = true;
+            break;
+        }
+
+        Eigen::VectorXd d = direction(gradient);
+        if (gradient.dot(d) >= 0.0) {
+            // Stale curvature pairs: fall back to steepest descent
+            s_.clear();
+            y_.clear();
+            d = -gradient;
+        }
+
+        // Unit quasi-Newton step; the first one is scaled to unit length
+        double step = s_.empty() ? std::min(1.0, 1.0 / d.norm()) : 1.0;
+
+        Eigen::VectorXd x = result.x;
+        Eigen::VectorXd previousGradient = gradient;
+        double previousValue = result.value;
+        bool accepted = lineSearch(objective, x, result.value, gradient, d, step, result.evaluations);
+        result.iterations = iter + 1;
+
+        if (!accepted) {
+            // No Wolfe point: keep the best value seen and stop
+            if (result.value < previousValue) {
+                result.x = x;
+            } else {
+                result.value = previousValue;
+                gradient = previousGradient;
+            }
+            break;
+        }
+
+        Eigen::VectorXd s = x - result.x;
+        Eigen::VectorXd y = gradient - previousGradient;
+        result.x = x;
+
+        if (s.dot(y) > 1e-12 * s.norm() * y.norm()) {
+            s_.push_back(s);
+            y_.push_back(y);
+            if (static_cast<int>(s_.size()) > settings_.memory) {
+                s_.pop_front();
+                y_.pop_front();
+            }
+        }
+
+        if (monitor && !monitor(result.iterations, result.value)) {
+            break;
+        }
+
+        double decrease = previousValue - result.value;
+        if (decrease <= settings_.valueTolerance * std::max(1.0, std::abs(result.value))) {
+            result.converged = true;
+            break;
+        }
+    }
+
+    return result;
+}
+
+Eigen::VectorXd LBFGS::direction(const Eigen::VectorXd& gradient) const {
+    Eigen::VectorXd q = -gradient;
+    int m = static_cast<int>(s_.size());
+    std::vector<double> alpha(m);
+    std::vector<double> rho(m);
+
+    for (int i = m - 1; i >= 0; i--) {
+        rho[i] = 1.0 / y_[i].dot(s_[i]);
+        alpha[i] = rho[i] * s_[i].dot(q);
+        q -= alpha[i] * y_[i];
+    }
+
+    // Initial Hessian scaled to the most recent curvature
+    if (m > 0) {
+        q *= s_[m - 1].dot(y_[m - 1]) / y_[m - 1].squaredNorm();
+    }
+
+    for (int i = 0; i < m; i++) {
+        double beta = rho[i] * y_[i].dot(q);
+        q += (alpha[i] - beta) * s_[i];
+    }
+
+    return q;
+}
+
+bool LBFGS::lineSearch(
+    const Objective& objective,
+    Eigen::VectorXd& x,
+    double& value,
+    Eigen::VectorXd& gradient,
+    const Eigen::VectorXd& direction,
+    double step,
+    int& evaluations) const
+{
+    const Eigen::VectorXd origin = x;
+    const Trial start{0.0, value, gradient.dot(direction)};
+    Eigen::VectorXd trialGradient(x.size());
+
+    Trial best = start;
+    Eigen::VectorXd bestGradient = gradient;
+
+    auto evaluate = [&](double alpha) {
+        Eigen::VectorXd point = origin + alpha * direction;
+        Trial trial{alpha, objective(point, trialGradient), 0.0};
+        trial.slope = trialGradient.dot(direction);
+        evaluations++;
+        if (trial.value < best.value) {
+            best = trial;
+            bestGradient = trialGradient;
+        }
+        return trial;
+    };
+
+    auto accept = [&](const Trial& trial) {
+        x = origin + trial.step * direction;
+        value = trial.value;
+        gradient = trialGradient;
+        return true;
+    };
+
+    auto sufficientDecrease = [&](const Trial& trial) {
+        return trial.value <= start.value + settings_.c1 * trial.step * start.slope;
+    };
+
+    auto curvature = [&](const Trial& trial) {
+        return std::abs(trial.slope) <= -settings_.c2 * start.slope;
+    };
+
+    // Bracketing phase
+    Trial previous = start;
+    Trial lo = start;
+    Trial hi = start;
+    bool bracketed = false;
+    int calls = 0;
+
+    while (calls < settings_.maxLineSearch) {
+        Trial trial = evaluate(step);
+        calls++;
+
+        if (!sufficientDecrease(trial) || (calls > 1 && trial.value >= previous.value)) {
+            lo = previous;
+            hi = trial;
+            bracketed = true;
+            break;
+        }
+        if (curvature(trial)) {
+            return accept(trial);
+        }
+        if (trial.slope >= 0.0) {
+            lo = trial;
+            hi = previous;
+            bracketed = true;
+            break;
+        }
+
+        previous = trial;
+        step *= 2.0;
+    }
+
+    // Zoom phase
+    while (bracketed && calls < settings_.maxLineSearch) {
+        Trial trial = evaluate(interpolate(lo, hi));
+        calls++;
+
+        if (!sufficientDecrease(trial) || trial.value >= lo.value) {
+            hi = trial;
+        } else {
+            if (curvature(trial)) {
+                return accept(trial);
+            }
+            if (trial.slope * (hi.step - lo.step) >= 0.0) {
+                hi = lo;
+            }
+            lo = trial;
+        }
+
+        if (std::abs(hi.step - lo.step) < 1e-12 * std::max(1.0, lo.step)) {
+            break;
+        }
+    }
+
+    // Limits reached: report the best point seen
+    x = origin + best.step * direction;
+    value = best.value;
+    gradient = bestGradient;
+    return false;
+}
+
+} // namespace Optimizers
+} // namespace LineFollower
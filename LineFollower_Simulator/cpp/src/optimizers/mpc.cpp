@@ -0,0 +1,163 @@
+/**
+ * @file mpc.cpp
+ * @brief Implementation of the model predictive controller
+ */
+
+#include "../../include/optimizers/mpc.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace LineFollower {
+namespace Optimizers {
+
+namespace {
+
+// Speed the heading-to-offset coupling is linearized at when nearly stopped
+constexpr float MIN_LINEARIZATION_SPEED = 0.05f;
+
+// Iterations between wall-clock checks
+constexpr int CLOCK_INTERVAL = 4;
+
+using State = Eigen::Matrix<float, MPC_STATES, 1>;
+using StateMatrix = Eigen::Matrix<float, MPC_STATES, MPC_STATES>;
+
+} // namespace
+
+MPC::MPC(const MPCSettings& settings, float wheelbase, float maxSpeed, float wheelAcceleration)
+    : settings_(settings)
+    , wheelbase_(wheelbase)
+    , maxSpeed_(maxSpeed)
+    , warm_(false)
+    , iterations_(0)
+{
+    // Exact discretization of the first-order wheel lag dw/dt = a(u - w/V)
+    lag_ = std::exp(-settings_.horizonStep * wheelAcceleration / maxSpeed_);
+    gain_ = maxSpeed_ * (1.0f - lag_);
+    commands_.setZero();
+}
+
+void MPC::reset() {
+    warm_ = false;
+    iterations_ = 0;
+    commands_.setZero();
+}
+
+bool MPC::solve(const MPCInput& input, float& leftCommand, float& rightCommand) {
+    const auto start = std::chrono::steady_clock::now();
+    auto overBudget = [&]() {
+        if (settings_.budgetMicros <= 0.0f) {
+            return false;
+        }
+        std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() > settings_.budgetMicros;
+    };
+
+    const float h = settings_.horizonStep;
+    const float speed = std::max(0.5f * (input.leftSpeed + input.rightSpeed), MIN_LINEARIZATION_SPEED);
+
+    // Stage cost: offsets plus squared speed error, v = (wL + wR) / 2
+    StateMatrix stageCost = StateMatrix::Zero();
+    stageCost(0, 0) = settings_.lateralWeight;
+    stageCost(1, 1) = settings_.headingWeight;
+    stageCost.bottomRightCorner<2, 2>().setConstant(0.25f * settings_.speedWeight);
+
+    // Condense x_{k+1} = A_k x_k + B u_k over the horizon: gamma_ maps the
+    // commands to the stacked states, free_ is the unforced response
+    gamma_.setZero();
+    State x;
+    x << input.lateralError, input.headingError, input.leftSpeed, input.rightSpeed;
+    linear_.setZero();
+
+    for (int k = 0; k < MPC_HORIZON; k++) {
+        StateMatrix a = StateMatrix::Zero();
+        a(0, 0) = 1.0f;
+        a(0, 1) = h * speed;
+        a(1, 1) = 1.0f;
+        a(1, 2) = -h * (1.0f / wheelbase_ + 0.5f * input.curvature[k]);
+        a(1, 3) = h * (1.0f / wheelbase_ - 0.5f * input.curvature[k]);
+        a(2, 2) = lag_;
+        a(3, 3) = lag_;
+
+        const int row = k * MPC_STATES;
+        x = a * x;
+        free_.segment<MPC_STATES>(row) = x;
+        if (k > 0) {
+            gamma_.block<MPC_STATES, MPC_VARIABLES>(row, 0).noalias() =
+                a * gamma_.block<MPC_STATES, MPC_VARIABLES>(row - MPC_STATES, 0);
+        }
+        gamma_(row + 2, k * MPC_CONTROLS) = gain_;
+        gamma_(row + 3, k * MPC_CONTROLS + 1) = gain_;
+
+        // Weighted prediction and the linear term of the condensed cost
+        weighted_.block<MPC_STATES, MPC_VARIABLES>(row, 0).noalias() =
+            stageCost * gamma_.block<MPC_STATES, MPC_VARIABLES>(row, 0);
+        State target = stageCost * x;
+        target.tail<2>().array() -= 0.5f * settings_.speedWeight * input.referenceSpeed[k];
+        linear_.noalias() += gamma_.block<MPC_STATES, MPC_VARIABLES>(row, 0).transpose() * target;
+    }
+    hessian_.noalias() = gamma_.transpose() * weighted_;
+
+    // Command smoothness, including the step from the applied command
+    const float r = settings_.smoothWeight;
+    for (int k = 0; k < MPC_HORIZON; k++) {
+        for (int c = 0; c < MPC_CONTROLS; c++) {
+            int i = k * MPC_CONTROLS + c;
+            hessian_(i, i) += (k + 1 < MPC_HORIZON) ? 2.0f * r : r;
+            if (k + 1 < MPC_HORIZON) {
+                hessian_(i, i + MPC_CONTROLS) -= r;
+                hessian_(i + MPC_CONTROLS, i) -= r;
+            }
+        }
+    }
+    linear_[0] -= r * input.leftCommand;
+    linear_[1] -= r * input.rightCommand;
+
+    // Step size from a Gershgorin bound on the largest eigenvalue
+    const float lipschitz = hessian_.cwiseAbs().rowwise().sum().maxCoeff();
+    if (!(lipschitz > 0.0f)) {
+        return false;
+    }
+
+    // Warm start: last solution shifted one stage, final stage repeated
+    if (warm_) {
+        commands_.head<MPC_VARIABLES - MPC_CONTROLS>() = commands_.tail<MPC_VARIABLES - MPC_CONTROLS>().eval();
+    } else {
+        for (int k = 0; k < MPC_HORIZON; k++) {
+            commands_[k * MPC_CONTROLS] = input.leftCommand;
+            commands_[k * MPC_CONTROLS + 1] = input.rightCommand;
+        }
+    }
+    commands_ = commands_.cwiseMax(0.0f).cwiseMin(1.0f);
+    warm_ = true;
+
+    // Accelerated projected gradient (FISTA) on the box [0, 1]
+    momentum_ = commands_;
+    float t = 1.0f;
+    iterations_ = 0;
+    for (int iter = 0; iter < settings_.maxIterations; iter++) {
+        if (iter % CLOCK_INTERVAL == 0 && overBudget()) {
+            return false;
+        }
+        previous_ = commands_;
+        commands_.noalias() = momentum_ - (hessian_ * momentum_ + linear_) / lipschitz;
+        commands_ = commands_.cwiseMax(0.0f).cwiseMin(1.0f);
+        iterations_ = iter + 1;
+
+        float change = (commands_ - previous_).cwiseAbs().maxCoeff();
+        if (change < settings_.tolerance) {
+            break;
+        }
+        float next = 0.5f * (1.0f + std::sqrt(1.0f + 4.0f * t * t));
+        momentum_ = commands_ + ((t - 1.0f) / next) * (commands_ - previous_);
+        t = next;
+    }
+
+    // The iterate is always feasible, so an iteration cap still yields a command
+    leftCommand = commands_[0];
+    rightCommand = commands_[1];
+    return true;
+}
+
+} // namespace Optimizers
+} // namespace LineFollower
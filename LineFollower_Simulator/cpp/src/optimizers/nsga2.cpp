@@ -0,0 +1,356 @@
+/**
+ * @file nsga2.cpp
+ * @brief Implementation of NSGA-II
+ */
+
+#include "../../include/optimizers/nsga2.hpp"
+#include "../../include/checkpoint.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace LineFollower {
+namespace Optimizers {
+
+namespace {
+
+// Parents below this are too few for tournaments to select anything
+constexpr int MIN_POPULATION = 4;
+
+// Variables closer than this are not recombined
+constexpr double CROSSOVER_MIN_SPREAD = 1e-14;
+
+} // namespace
+
+NSGA2::NSGA2(
+    const Eigen::VectorXd& start,
+    const Eigen::VectorXd& lower,
+    const Eigen::VectorXd& upper,
+    int populationSize,
+    uint32_t seed,
+    const NSGA2Settings& settings)
+    : n_(static_cast<int>(start.size()))
+    , lower_(lower)
+    , upper_(upper)
+    , start_(start.cwiseMax(lower).cwiseMin(upper))
+    , settings_(settings)
+    , generation_(0)
+    , rng_(seed)
+{
+    // Offspring come in pairs
+    size_ = std::max(populationSize, MIN_POPULATION);
+    size_ += size_ % 2;
+    if (settings_.mutationProbability <= 0.0) {
+        settings_.mutationProbability = 1.0 / std::max(n_, 1);
+    }
+}
+
+const std::vector<Eigen::VectorXd>& NSGA2::ask() {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    offspring_.clear();
+
+    if (parents_.empty()) {
+        offspring_.push_back(start_);
+        while (static_cast<int>(offspring_.size()) < size_) {
+            Eigen::VectorXd x(n_);
+            for (int i = 0; i < n_; i++) {
+                x[i] = lower_[i] + uniform(rng_) * (upper_[i] - lower_[i]);
+            }
+            offspring_.push_back(x);
+        }
+        return offspring_;
+    }
+
+    while (static_cast<int>(offspring_.size()) < size_) {
+        Eigen::VectorXd a = parents_[tournament()];
+        Eigen::VectorXd b = parents_[tournament()];
+        if (uniform(rng_) < settings_.crossoverProbability) {
+            crossover(a, b);
+        }
+        mutate(a);
+        mutate(b);
+        offspring_.push_back(a);
+        offspring_.push_back(b);
+    }
+    return offspring_;
+}
+
+void NSGA2::tell(const std::vector<Eigen::VectorXd>& objectives, const std::vector<double>& violations) {
+    // Elitist: parents and offspring compete for the next generation
+    std::vector<Eigen::VectorXd> pool = parents_;
+    std::vector<Eigen::VectorXd> poolObjectives = objectives_;
+    std::vector<double> poolViolations = violations_;
+    pool.insert(pool.end(), offspring_.begin(), offspring_.end());
+    poolObjectives.insert(poolObjectives.end(), objectives.begin(), objectives.end());
+    poolViolations.insert(poolViolations.end(), violations.begin(), violations.end());
+
+    std::vector<std::vector<int>> fronts = sortFronts(poolObjectives, poolViolations);
+    std::vector<int> survivors;
+    std::vector<double> distance(pool.size(), 0.0);
+    for (const std::vector<int>& front : fronts) {
+        if (survivors.size() + front.size() <= static_cast<size_t>(size_)) {
+            survivors.insert(survivors.end(), front.begin(), front.end());
+            continue;
+        }
+
+        // Last front only partly fits: keep its least crowded members
+        crowdingDistance(poolObjectives, front, distance);
+        std::vector<int> order = front;
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return distance[a] > distance[b]; });
+        order.resize(size_ - survivors.size());
+        survivors.insert(survivors.end(), order.begin(), order.end());
+        break;
+    }
+
+    parents_.clear();
+    objectives_.clear();
+    violations_.clear();
+    for (int k : survivors) {
+        parents_.push_back(pool[k]);
+        objectives_.push_back(poolObjectives[k]);
+        violations_.push_back(poolViolations[k]);
+    }
+    rankParents();
+    generation_++;
+}
+
+std::vector<int> NSGA2::front() const {
+    std::vector<int> members;
+    for (int k = 0; k < static_cast<int>(parents_.size()); k++) {
+        if (rank_[k] == 0 && violations_[k] <= 0.0) {
+            members.push_back(k);
+        }
+    }
+    return members;
+}
+
+void NSGA2::save(CheckpointWriter& out) const {
+    out.write(static_cast<int32_t>(n_));
+    out.write(static_cast<int32_t>(size_));
+    out.write(static_cast<int32_t>(generation_));
+    out.write(static_cast<uint32_t>(parents_.size()));
+    for (size_t k = 0; k < parents_.size(); k++) {
+        out.write(parents_[k]);
+        out.write(objectives_[k]);
+    }
+    out.write(violations_);
+    out.write(rng_);
+}
+
+bool NSGA2::restore(CheckpointReader& in) {
+    int32_t n = 0;
+    int32_t size = 0;
+    int32_t generation = 0;
+    uint32_t count = 0;
+    in.read(n);
+    in.read(size);
+    in.read(generation);
+    in.read(count);
+    if (!in.ok() || n != n_ || size != size_ || count > static_cast<uint32_t>(size_)) {
+        return false;
+    }
+
+    std::vector<Eigen::VectorXd> parents(count);
+    std::vector<Eigen::VectorXd> objectives(count);
+    std::vector<double> violations;
+    for (uint32_t k = 0; k < count && in.ok(); k++) {
+        in.read(parents[k]);
+        in.read(objectives[k]);
+    }
+    in.read(violations);
+    in.read(rng_);
+    if (!in.ok() || violations.size() != count) {
+        return false;
+    }
+    for (uint32_t k = 0; k < count; k++) {
+        if (parents[k].size() != n_ || objectives[k].size() != objectives[0].size()) {
+            return false;
+        }
+    }
+
+    generation_ = generation;
+    parents_ = parents;
+    objectives_ = objectives;
+    violations_ = violations;
+    rankParents();
+    return true;
+}
+
+bool NSGA2::dominates(
+    const Eigen::VectorXd& a, double violationA,
+    const Eigen::VectorXd& b, double violationB)
+{
+    if (violationA > 0.0 || violationB > 0.0) {
+        return violationA < violationB;
+    }
+
+    bool better = false;
+    for (int k = 0; k < a.size(); k++) {
+        if (a[k] > b[k]) {
+            return false;
+        }
+        if (a[k] < b[k]) {
+            better = true;
+        }
+    }
+    return better;
+}
+
+std::vector<std::vector<int>> NSGA2::sortFronts(
+    const std::vector<Eigen::VectorXd>& objectives,
+    const std::vector<double>& violations)
+{
+    int count = static_cast<int>(objectives.size());
+    std::vector<std::vector<int>> dominated(count);   // points each one dominates
+    std::vector<int> dominators(count, 0);            // points dominating each one
+    std::vector<std::vector<int>> fronts(1);
+
+    for (int p = 0; p < count; p++) {
+        for (int q = p + 1; q < count; q++) {
+            if (dominates(objectives[p], violations[p], objectives[q], violations[q])) {
+                dominated[p].push_back(q);
+                dominators[q]++;
+            } else if (dominates(objectives[q], violations[q], objectives[p], violations[p])) {
+                dominated[q].push_back(p);
+                dominators[p]++;
+            }
+        }
+    }
+    for (int p = 0; p < count; p++) {
+        if (dominators[p] == 0) {
+            fronts[0].push_back(p);
+        }
+    }
+
+    // Peel fronts: removing one front frees the points only it dominated
+    for (size_t f = 0; !fronts[f].empty(); f++) {
+        std::vector<int> next;
+        for (int p : fronts[f]) {
+            for (int q : dominated[p]) {
+                if (--dominators[q] == 0) {
+                    next.push_back(q);
+                }
+            }
+        }
+        fronts.push_back(next);
+    }
+    fronts.pop_back();
+    return fronts;
+}
+
+void NSGA2::crowdingDistance(
+    const std::vector<Eigen::VectorXd>& objectives,
+    const std::vector<int>& front,
+    std::vector<double>& distance)
+{
+    for (int p : front) {
+        distance[p] = 0.0;
+    }
+    if (front.size() <= 2) {
+        for (int p : front) {
+            distance[p] = std::numeric_limits<double>::infinity();
+        }
+        return;
+    }
+
+    std::vector<int> order = front;
+    int m = static_cast<int>(objectives[front[0]].size());
+    for (int k = 0; k < m; k++) {
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return objectives[a][k] < objectives[b][k]; });
+        double range = objectives[order.back()][k] - objectives[order.front()][k];
+        distance[order.front()] = std::numeric_limits<double>::infinity();
+        distance[order.back()] = std::numeric_limits<double>::infinity();
+        if (range <= 0.0) {
+            continue;
+        }
+        for (size_t i = 1; i + 1 < order.size(); i++) {
+            distance[order[i]] += (objectives[order[i + 1]][k] - objectives[order[i - 1]][k]) / range;
+        }
+    }
+}
+
+void NSGA2::rankParents() {
+    rank_.assign(parents_.size(), 0);
+    crowding_.assign(parents_.size(), 0.0);
+    std::vector<std::vector<int>> fronts = sortFronts(objectives_, violations_);
+    for (size_t f = 0; f < fronts.size(); f++) {
+        for (int p : fronts[f]) {
+            rank_[p] = static_cast<int>(f);
+        }
+        crowdingDistance(objectives_, fronts[f], crowding_);
+    }
+}
+
+int NSGA2::tournament() {
+    std::uniform_int_distribution<int> pick(0, static_cast<int>(parents_.size()) - 1);
+    int a = pick(rng_);
+    int b = pick(rng_);
+    if (rank_[a] != rank_[b]) {
+        return rank_[a] < rank_[b] ? a : b;
+    }
+    return crowding_[a] >= crowding_[b] ? a : b;
+}
+
+void NSGA2::crossover(Eigen::VectorXd& a, Eigen::VectorXd& b) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double exponent = 1.0 / (settings_.crossoverEta + 1.0);
+
+    // Spread factor whose distribution is cut off at the bound
+    auto spread = [&](double u, double beta) {
+        double alpha = 2.0 - std::pow(beta, -(settings_.crossoverEta + 1.0));
+        return u <= 1.0 / alpha
+            ? std::pow(u * alpha, exponent)
+            : std::pow(1.0 / (2.0 - u * alpha), exponent);
+    };
+
+    for (int i = 0; i < n_; i++) {
+        if (uniform(rng_) > 0.5 || std::abs(a[i] - b[i]) <= CROSSOVER_MIN_SPREAD) {
+            continue;
+        }
+        double y1 = std::min(a[i], b[i]);
+        double y2 = std::max(a[i], b[i]);
+        double u = uniform(rng_);
+
+        double c1 = 0.5 * ((y1 + y2) - spread(u, 1.0 + 2.0 * (y1 - lower_[i]) / (y2 - y1)) * (y2 - y1));
+        double c2 = 0.5 * ((y1 + y2) + spread(u, 1.0 + 2.0 * (upper_[i] - y2) / (y2 - y1)) * (y2 - y1));
+        c1 = std::min(std::max(c1, lower_[i]), upper_[i]);
+        c2 = std::min(std::max(c2, lower_[i]), upper_[i]);
+
+        if (uniform(rng_) < 0.5) {
+            std::swap(c1, c2);
+        }
+        a[i] = c1;
+        b[i] = c2;
+    }
+}
+
+void NSGA2::mutate(Eigen::VectorXd& x) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    double exponent = 1.0 / (settings_.mutationEta + 1.0);
+
+    for (int i = 0; i < n_; i++) {
+        if (uniform(rng_) >= settings_.mutationProbability) {
+            continue;
+        }
+        double width = upper_[i] - lower_[i];
+        if (width <= 0.0) {
+            continue;
+        }
+        double u = uniform(rng_);
+        double delta;
+        if (u < 0.5) {
+            double reach = 1.0 - (x[i] - lower_[i]) / width;
+            double value = 2.0 * u + (1.0 - 2.0 * u) * std::pow(reach, settings_.mutationEta + 1.0);
+            delta = std::pow(value, exponent) - 1.0;
+        } else {
+            double reach = 1.0 - (upper_[i] - x[i]) / width;
+            double value = 2.0 * (1.0 - u) + 2.0 * (u - 0.5) * std::pow(reach, settings_.mutationEta + 1.0);
+            delta = 1.0 - std::pow(value, exponent);
+        }
+        x[i] = std::min(std::max(x[i] + delta * width, lower_[i]), upper_[i]);
+    }
+}
+
+} // namespace Optimizers
+} // namespace LineFollower
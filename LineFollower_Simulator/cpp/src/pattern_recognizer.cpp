@@ -4,10 +4,34 @@
  */
 
 #include "../include/pattern_recognizer.hpp"
+#include "../include/compiled_track.hpp"
 #include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
 
 namespace LineFollower {
 
+namespace {
+
+// Runs of one label shorter than this are noise (m)
+constexpr float MIN_RUN_LENGTH = 0.05f;
+
+// Hairpin: at least 150 degrees of turning on a tight radius
+constexpr float HAIRPIN_MIN_ANGLE = 2.618f;
+constexpr float HAIRPIN_MAX_RADIUS = 0.25f;   // m
+
+// Spiral: curvature change along the curve relative to its mean, and the
+// share of curvature variance a straight-line fit must explain
+constexpr double SPIRAL_MIN_CHANGE = 0.5;
+constexpr double SPIRAL_MIN_FIT = 0.8;
+
+// S-curve: the smaller lobe turns at least this share of the larger
+constexpr float S_CURVE_BALANCE = 0.3f;
+
+} // namespace
+
 PatternRecognizer::PatternRecognizer()
     : straightTolerance_(0.01f)
     , circleTolerance_(0.1f)
@@ -17,101 +41,313 @@ PatternRecognizer::PatternRecognizer()
 std::vector<Artifact> PatternRecognizer::recognizeArtifacts(
     const std::vector<TrackPoint>& trackPoints)
 {
-    std::vector<Artifact> artifacts;
+    if (trackPoints.size() < 3) {
+        return std::vector<Artifact>();
+    }
 
-    // TODO: Implement full pattern recognition in Phase 2
-    // For Phase 1, create a single complex artifact for the entire track
+    CompiledTrack track(trackPoints);
+    return recognizeArtifacts(track);
+}
 
-    if (trackPoints.size() < 3) {
+std::vector<Artifact> PatternRecognizer::recognizeArtifacts(const CompiledTrack& track) {
+    std::vector<Artifact> artifacts;
+    if (track.points().size() < 3 || track.size() < 2) {
         return artifacts;
     }
 
-    Artifact fullTrack;
-    fullTrack.type = ArtifactType::COMPLEX;
-    fullTrack.startIndex = 0;
-    fullTrack.endIndex = static_cast<int>(trackPoints.size()) - 1;
-    fullTrack.length = calculateSegmentLength(trackPoints, 0, fullTrack.endIndex);
-    fullTrack.curvature = 0.0f; // Will be calculated properly later
-    fullTrack.radius = 0.0f;
-    fullTrack.description = "Full track (Phase 1 - no decomposition yet)";
+    // Label every sample straight (0) or by turning direction, then split
+    // into runs of equal label
+    const std::vector<float>& curvature = track.curvature();
+    int n = track.size();
+    std::vector<Run> runs;
+    for (int k = 0; k < n; k++) {
+        int label = std::abs(curvature[k]) < straightTolerance_ ? 0 : (curvature[k] > 0.0f ? 1 : -1);
+        if (runs.empty() || runs.back().label != label) {
+            runs.push_back(Run{label, k, k});
+        } else {
+            runs.back().end = k;
+        }
+    }
+
+    // Fold runs too short to matter into their predecessor, then rejoin
+    // neighbours that ended up with the same label
+    int minSamples = std::max(1, static_cast<int>(std::ceil(MIN_RUN_LENGTH / track.spacing())));
+    std::vector<Run> merged;
+    for (const Run& run : runs) {
+        if (!merged.empty() && (run.end - run.start + 1 < minSamples || merged.back().label == run.label)) {
+            merged.back().end = run.end;
+        } else {
+            merged.push_back(run);
+        }
+    }
+    if (merged.size() > 1 && merged[0].end - merged[0].start + 1 < minSamples) {
+        merged[1].start = merged[0].start;
+        merged.erase(merged.begin());
+    }
 
-    artifacts.push_back(fullTrack);
+    // Straights stand alone; consecutive curves with no straight between
+    // them form one artifact (S-curve or chicane when more than one)
+    size_t r = 0;
+    while (r < merged.size()) {
+        size_t last = r;
+        if (merged[r].label != 0) {
+            while (last + 1 < merged.size() && merged[last + 1].label != 0) {
+                last++;
+            }
+        }
+        int lobes = merged[r].label == 0 ? 0 : static_cast<int>(last - r + 1);
+        Artifact artifact = classify(track, merged[r].start, merged[last].end, lobes);
+
+        // Map the sample range to original points; artifacts share their
+        // boundary point so they tile the track
+        artifact.startIndex = artifacts.empty() ? 0 : artifacts.back().endIndex;
+        artifact.endIndex = last + 1 == merged.size()
+            ? static_cast<int>(track.points().size()) - 1
+            : nearestPoint(track, track.arcLength()[merged[last].end]);
+        if (artifact.endIndex <= artifact.startIndex) {
+            // Shorter than one original segment: the next artifact absorbs it
+            r = last + 1;
+            continue;
+        }
+        artifact.length = calculateSegmentLength(track, artifact.startIndex, artifact.endIndex);
+        artifacts.push_back(artifact);
+        r = last + 1;
+    }
+
+    // A tail shorter than one segment was skipped; extend the last artifact
+    if (!artifacts.empty()) {
+        Artifact& tail = artifacts.back();
+        tail.endIndex = static_cast<int>(track.points().size()) - 1;
+        tail.length = calculateSegmentLength(track, tail.startIndex, tail.endIndex);
+    }
 
     return artifacts;
 }
 
+Artifact PatternRecognizer::classify(
+    const CompiledTrack& track,
+    int start,
+    int end,
+    int lobes) const
+{
+    CurveStats stats = curveStats(track, start, end);
+
+    Artifact artifact;
+    artifact.type = ArtifactType::COMPLEX;
+    artifact.startIndex = 0;
+    artifact.endIndex = 0;
+    artifact.length = stats.length;
+    artifact.curvature = stats.meanCurvature;
+    artifact.radius = stats.meanCurvature > 0.0f ? 1.0f / stats.meanCurvature : 0.0f;
+    artifact.turnAngle = stats.turnAngle;
+    artifact.peakCurvature = stats.peakCurvature;
+    artifact.entryCurvature = stats.entryCurvature;
+    artifact.exitCurvature = stats.exitCurvature;
+    artifact.lobes = lobes;
+
+    float circleRadius = 0.0f;
+    char text[128];
+    float degrees = stats.turnAngle * 180.0f / Physics::PI;
+    if (lobes == 0 || isStraight(track, start, end)) {
+        artifact.type = ArtifactType::STRAIGHT;
+        artifact.curvature = 0.0f;
+        artifact.radius = 0.0f;
+        std::snprintf(text, sizeof(text), "Straight %.2f m", stats.length);
+    } else if (lobes == 1 && isHairpin(track, start, end)) {
+        artifact.type = ArtifactType::HAIRPIN;
+        std::snprintf(text, sizeof(text), "Hairpin R=%.2f m, %.0f deg", artifact.radius, degrees);
+    } else if (lobes == 1 && isCircularCurve(track, start, end, circleRadius)) {
+        artifact.type = ArtifactType::CIRCULAR_CURVE;
+        artifact.radius = circleRadius;
+        std::snprintf(text, sizeof(text), "Circular curve R=%.2f m, %.0f deg", artifact.radius, degrees);
+    } else if (lobes == 1 && isSpiral(track, start, end)) {
+        artifact.type = ArtifactType::SPIRAL;
+        std::snprintf(text, sizeof(text), "Spiral R=%.2f to %.2f m, %.0f deg",
+            1.0f / std::max(stats.entryCurvature, straightTolerance_),
+            1.0f / std::max(stats.exitCurvature, straightTolerance_), degrees);
+    } else if (lobes == 2 && isSCurve(track, start, end)) {
+        artifact.type = ArtifactType::S_CURVE;
+        std::snprintf(text, sizeof(text), "S-curve, tightest R=%.2f m", 1.0f / stats.peakCurvature);
+    } else if (lobes >= 2) {
+        artifact.type = ArtifactType::CHICANE;
+        std::snprintf(text, sizeof(text), "Chicane, %d curves, tightest R=%.2f m", lobes, 1.0f / stats.peakCurvature);
+    } else {
+        std::snprintf(text, sizeof(text), "Complex curve %.2f m, %.0f deg", stats.length, degrees);
+    }
+    artifact.description = text;
+    return artifact;
+}
+
+PatternRecognizer::CurveStats PatternRecognizer::curveStats(
+    const CompiledTrack& track,
+    int start,
+    int end) const
+{
+    const std::vector<float>& curvature = track.curvature();
+    float spacing = track.spacing();
+
+    CurveStats stats;
+    stats.length = (end - start) * spacing;
+    stats.turnAngle = 0.0f;
+    for (int k = start; k < end; k++) {
+        stats.turnAngle += 0.5f * (std::abs(curvature[k]) + std::abs(curvature[k + 1])) * spacing;
+    }
+    stats.meanCurvature = stats.length > 0.0f ? stats.turnAngle / stats.length : 0.0f;
+    stats.peakCurvature = track.maxCurvature(track.arcLength()[start], track.arcLength()[end]);
+
+    // Ends averaged over their outer fifth, past the smoothing ramp
+    int window = std::max(1, (end - start) / 5);
+    float entry = 0.0f;
+    float exit = 0.0f;
+    for (int k = 0; k < window; k++) {
+        entry += std::abs(curvature[std::min(start + window / 2 + k, end)]);
+        exit += std::abs(curvature[std::max(end - window / 2 - k, start)]);
+    }
+    stats.entryCurvature = entry / window;
+    stats.exitCurvature = exit / window;
+    return stats;
+}
+
+int PatternRecognizer::nearestPoint(const CompiledTrack& track, float arcLength) const {
+    int segment = track.segmentAt(arcLength);
+    int last = static_cast<int>(track.points().size()) - 1;
+    if (segment + 1 <= last &&
+        track.pointArcLength(segment + 1) - arcLength < arcLength - track.pointArcLength(segment)) {
+        return segment + 1;
+    }
+    return segment;
+}
+
 void PatternRecognizer::setTolerances(float straightTolerance, float circleTolerance) {
     straightTolerance_ = straightTolerance;
     circleTolerance_ = circleTolerance;
 }
 
 bool PatternRecognizer::isStraight(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int start,
     int end) const
 {
-    // TODO: Implement in Phase 2
-    return false;
+    return track.maxCurvature(track.arcLength()[start], track.arcLength()[end]) < straightTolerance_;
 }
 
 bool PatternRecognizer::isCircularCurve(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int start,
     int end,
     float& radius) const
 {
-    // TODO: Implement in Phase 2
-    radius = 0.0f;
-    return false;
+    // Radius spread over the middle, where the smoothing ramps have faded
+    const std::vector<float>& curvature = track.curvature();
+    int margin = (end - start) / 10;
+    float low = std::numeric_limits<float>::max();
+    float high = 0.0f;
+    float sum = 0.0f;
+    for (int k = start + margin; k <= end - margin; k++) {
+        float k1 = std::abs(curvature[k]);
+        low = std::min(low, k1);
+        high = std::max(high, k1);
+        sum += k1;
+    }
+    float mean = sum / (end - start - 2 * margin + 1);
+    if (mean < straightTolerance_ || (1.0f / low - 1.0f / high) * mean > circleTolerance_) {
+        radius = 0.0f;
+        return false;
+    }
+    radius = 1.0f / mean;
+    return true;
 }
 
 bool PatternRecognizer::isSCurve(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int start,
     int end) const
 {
-    // TODO: Implement in Phase 2
-    return false;
+    // Two lobes of comparable turning: a small wiggle before a big curve
+    // is not an S
+    const std::vector<float>& curvature = track.curvature();
+    float spacing = track.spacing();
+    float lobe[2] = {0.0f, 0.0f};
+    int sign = curvature[start] >= 0.0f ? 1 : -1;
+    int current = 0;
+    for (int k = start; k <= end; k++) {
+        if (std::abs(curvature[k]) < straightTolerance_) {
+            continue;
+        }
+        int s = curvature[k] > 0.0f ? 1 : -1;
+        if (s != sign) {
+            sign = s;
+            current = std::min(current + 1, 1);
+        }
+        lobe[current] += std::abs(curvature[k]) * spacing;
+    }
+    float smaller = std::min(lobe[0], lobe[1]);
+    float larger = std::max(lobe[0], lobe[1]);
+    return larger > 0.0f && smaller >= S_CURVE_BALANCE * larger;
 }
 
 bool PatternRecognizer::isHairpin(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int start,
     int end) const
 {
-    // TODO: Implement in Phase 2
-    return false;
+    CurveStats stats = curveStats(track, start, end);
+    return stats.turnAngle >= HAIRPIN_MIN_ANGLE &&
+           stats.meanCurvature > 0.0f && 1.0f / stats.meanCurvature <= HAIRPIN_MAX_RADIUS;
+}
+
+bool PatternRecognizer::isSpiral(
+    const CompiledTrack& track,
+    int start,
+    int end) const
+{
+    // Least-squares line through |curvature| over arc length: a spiral
+    // changes curvature substantially and the line explains most of it
+    const std::vector<float>& curvature = track.curvature();
+    int count = end - start + 1;
+    if (count < 3) {
+        return false;
+    }
+    double sumT = 0.0, sumK = 0.0, sumTT = 0.0, sumTK = 0.0, sumKK = 0.0;
+    for (int k = start; k <= end; k++) {
+        double t = k - start;
+        double kk = std::abs(curvature[k]);
+        sumT += t;
+        sumK += kk;
+        sumTT += t * t;
+        sumTK += t * kk;
+        sumKK += kk * kk;
+    }
+    double varT = sumTT - sumT * sumT / count;
+    double varK = sumKK - sumK * sumK / count;
+    double cov = sumTK - sumT * sumK / count;
+    if (varT <= 0.0 || varK <= 0.0) {
+        return false;
+    }
+    double r2 = cov * cov / (varT * varK);
+    double mean = sumK / count;
+    double change = std::abs(cov / varT) * (count - 1);
+    return r2 >= SPIRAL_MIN_FIT && change >= SPIRAL_MIN_CHANGE * mean;
 }
 
 float PatternRecognizer::calculateSegmentCurvature(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int index) const
 {
-    if (index <= 0 || index >= static_cast<int>(points.size()) - 1) {
+    if (index < 0 || index >= static_cast<int>(track.points().size())) {
         return 0.0f;
     }
 
-    Physics::Vec2 prev(points[index - 1].x, points[index - 1].y);
-    Physics::Vec2 curr(points[index].x, points[index].y);
-    Physics::Vec2 next(points[index + 1].x, points[index + 1].y);
-
-    return Physics::calculateCurvature(prev, curr, next);
+    // Smoothed curvature cached by the compiled track
+    return track.curvatureAt(track.pointArcLength(index));
 }
 
 float PatternRecognizer::calculateSegmentLength(
-    const std::vector<TrackPoint>& points,
+    const CompiledTrack& track,
     int start,
     int end) const
 {
-    float length = 0.0f;
-
-    for (int i = start; i < end; i++) {
-        Physics::Vec2 p1(points[i].x, points[i].y);
-        Physics::Vec2 p2(points[i + 1].x, points[i + 1].y);
-        length += Physics::distance(p1, p2);
-    }
-
-    return length;
+    return track.lengthBetween(start, end);
 }
 
 } // namespace LineFollower
@@ -18,7 +18,7 @@ float calculateCurvature(const Vec2& prev, const Vec2& curr, const Vec2& next) {
     float b = v2.length();
     float c = distance(prev, next);
 
-    if (a * b * c < 0.0001f) {
+    if (a * b * c < 1e-12f) {
         return 0.0f;
     }
 
@@ -5,58 +5,130 @@
 
 #include "../include/simulator.hpp"
 #include "../include/physics.hpp"
-// #include <box2d/box2d.h> // Will be included when Box2D is integrated
+#include "../include/compiled_track.hpp"
+#include "../include/distance_field.hpp"
+#include "../include/velocity_profile.hpp"
+#include "../include/optimizers/mpc.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
 
 namespace LineFollower {
 
+static_assert(std::is_trivially_copyable<SimulatorSnapshot>::value,
+              "SimulatorSnapshot must stay a POD blob");
+
+void ProgressMonitor::reset() {
+    progress = 0.0f;
+    stallProgress = 0.0f;
+    stallStart = 0.0f;
+    offTrackTime = 0.0f;
+    reason = FailureReason::NONE;
+}
+
+FailureReason ProgressMonitor::update(
+    const FailureCriteria& criteria,
+    float time,
+    float dt,
+    float arcLength,
+    float trackLength,
+    float lineDistance,
+    float offTrackDistance,
+    float headingAlignment,
+    float maxSpeed)
+{
+    progress = arcLength;
+    if (arcLength - stallProgress >= criteria.minProgress) {
+        stallProgress = arcLength;
+        stallStart = time;
+    }
+
+    if (lineDistance > offTrackDistance) {
+        offTrackTime += dt;
+    } else {
+        offTrackTime = 0.0f;
+    }
+
+    if (time >= criteria.timeout) {
+        reason = FailureReason::TIMEOUT;
+    } else if (offTrackTime > criteria.offTrackTime) {
+        reason = FailureReason::OFF_TRACK;
+    } else if (time - stallStart > criteria.stallTime) {
+        reason = FailureReason::STALLED;
+    } else if (headingAlignment < std::cos(criteria.maxHeadingError)) {
+        reason = FailureReason::REVERSED;
+    } else if (criteria.cutoffTime > 0.0f &&
+               time + (trackLength - arcLength) / maxSpeed > criteria.cutoffTime) {
+        // Optimistic bound: even at top speed the run cannot beat the cutoff
+        reason = FailureReason::CUTOFF;
+    }
+
+    return reason;
+}
+
 Simulator::Simulator(const RobotConfig& config, const std::vector<TrackPoint>& trackPoints)
-    : robotBody_(nullptr)
-    , config_(config)
-    , trackPoints_(trackPoints)
+    : Simulator(config, std::make_shared<const CompiledTrack>(trackPoints))
+{
+}
+
+Simulator::Simulator(const RobotConfig& config, std::shared_ptr<const CompiledTrack> track)
+    : config_(config)
+    , track_(std::move(track))
+    , fieldResolution_(0.0f)
+    , fieldMemoryLimit_(0)
+    , stallForce_(0.0f)
+    , traction_(0.0f)
+    , sensorRange_(0.0f)
+    , sensorNoise_(0.0f)
+    , noiseSeed_(0)
+    , noiseState_(Physics::noiseState(0))
+    , leftWheelSpeed_(0.0f)
+    , rightWheelSpeed_(0.0f)
+    , trackSegment_(0)
     , simulationTime_(0.0f)
     , completionTime_(-1.0f)
     , isComplete_(false)
     , hasFailed_(false)
     , prevError_(0.0f)
     , errorIntegral_(0.0f)
+    , relayAmplitude_(0.0f)
+    , relayHysteresis_(0.0f)
+    , relayOutput_(0.0f)
+    , mpcStep_(0.0f)
+    , mpcFallbacks_(0)
+    , failureCriteria_(FailureCriteria::defaults())
 {
+    monitor_.reset();
+    config_.sensorCount = Physics::clamp(config_.sensorCount, 1, MAX_SENSORS);
 }
 
 Simulator::~Simulator() {
-    // Cleanup will be implemented with Box2D integration
 }
 
 bool Simulator::initialize() {
-    // TODO: Initialize Box2D world in Phase 1
-    // world_ = std::make_unique<b2World>(b2Vec2(0.0f, -config_.gravity));
+    if (!track_ || track_->index().segmentCount() < 1) {
+        return false;
+    }
 
-    // TODO: Create robot body with proper physics
-    // TODO: Create track boundaries
-    // TODO: Initialize sensors
+    // Motor force at the ground and grip limit
+    stallForce_ = Physics::MOTOR_STALL_TORQUE / (0.5f * config_.wheelDiameter);
+    float friction = Physics::adjustFrictionForTemperature(
+        config_.frictionCoeff, config_.temperature);
+    traction_ = friction * config_.gravity;
+    sensorRange_ = Physics::sensorRange(config_.sensorHeight);
 
-    // Placeholder initialization
-    currentState_.posX = 0.0f;
-    currentState_.posY = 0.0f;
-    currentState_.velX = 0.0f;
-    currentState_.velY = 0.0f;
-    currentState_.heading = 0.0f;
-    currentState_.angularVel = 0.0f;
-    currentState_.sensorReadings.resize(config_.sensorCount, 0.0f);
-    currentState_.leftMotor = 0.0f;
-    currentState_.rightMotor = 0.0f;
-    currentState_.lineError = 0.0f;
-    currentState_.power = 0.0f;
-    currentState_.time = 0.0f;
+    setDistanceField(fieldResolution_, fieldMemoryLimit_);
+
+    reset();
 
     return true;
 }
 
 void Simulator::step(float dt) {
-    // TODO: Implement full physics step with Box2D
-
-    // Placeholder implementation
-    simulationTime_ += dt;
-    currentState_.time = simulationTime_;
+    if (isComplete_ || hasFailed_) {
+        return;
+    }
 
     // Update sensors
     updateSensors();
@@ -66,15 +138,66 @@ void Simulator::step(float dt) {
 
     // Calculate PID control
     float control = calculatePID(error, dt);
+    if (relayAmplitude_ > 0.0f) {
+        if (relayOutput_ == 0.0f) {
+            relayOutput_ = error >= 0.0f ? 1.0f : -1.0f;
+        } else if (error > relayHysteresis_) {
+            relayOutput_ = 1.0f;
+        } else if (error < -relayHysteresis_) {
+            relayOutput_ = -1.0f;
+        }
+        control = relayAmplitude_ * relayOutput_;
+    }
 
     // Apply motor commands
-    float leftPower = Physics::clamp(control + 0.5f, 0.0f, 1.0f);
-    float rightPower = Physics::clamp(-control + 0.5f, 0.0f, 1.0f);
+    float leftPower = Physics::clamp(control + BASE_POWER, 0.0f, 1.0f);
+    float rightPower = Physics::clamp(-control + BASE_POWER, 0.0f, 1.0f);
+    applyMPC(leftPower, rightPower);
     applyMotorCommands(leftPower, rightPower);
 
+    // Advance dynamics
+    integrate(dt);
+    simulationTime_ += dt;
+    currentState_.time = simulationTime_;
+
     // Check completion and failure
+    updateTrackProgress();
     checkCompletion();
-    checkFailure();
+    checkFailure(dt);
+}
+
+int Simulator::run(float dt, float maxTime, int decimation, float* frames, int maxFrames) {
+    decimation = std::max(decimation, 1);
+    int frameCount = 0;
+    int stepCount = 0;
+
+    while (!isComplete_ && !hasFailed_ && simulationTime_ < maxTime) {
+        step(dt);
+        stepCount++;
+        if (stepCount % decimation == 0 && frameCount < maxFrames) {
+            writeFrame(frames + frameCount * FRAME_STRIDE);
+            frameCount++;
+        }
+    }
+
+    // Always end on the final state
+    if (stepCount % decimation != 0 && frameCount < maxFrames) {
+        writeFrame(frames + frameCount * FRAME_STRIDE);
+        frameCount++;
+    }
+
+    return frameCount;
+}
+
+void Simulator::writeFrame(float* frame) const {
+    frame[0] = currentState_.time;
+    frame[1] = currentState_.posX;
+    frame[2] = currentState_.posY;
+    frame[3] = currentState_.heading;
+    frame[4] = currentState_.leftMotor;
+    frame[5] = currentState_.rightMotor;
+    frame[6] = currentState_.lineError;
+    frame[7] = currentState_.power;
 }
 
 void Simulator::reset() {
@@ -84,15 +207,34 @@ void Simulator::reset() {
     hasFailed_ = false;
     prevError_ = 0.0f;
     errorIntegral_ = 0.0f;
+    relayOutput_ = 0.0f;
+    leftWheelSpeed_ = 0.0f;
+    rightWheelSpeed_ = 0.0f;
+    trackSegment_ = 0;
+    noiseState_ = Physics::noiseState(noiseSeed_);
+    monitor_.reset();
+    mpcFallbacks_ = 0;
+    if (mpc_) {
+        mpc_->reset();
+    }
 
-    // Reset state
+    // Reset state at track start, facing along the first segment
     currentState_.posX = 0.0f;
     currentState_.posY = 0.0f;
+    currentState_.heading = 0.0f;
+    if (track_ && track_->index().segmentCount() >= 1) {
+        const std::vector<TrackPoint>& points = track_->points();
+        currentState_.posX = points[0].x;
+        currentState_.posY = points[0].y;
+        currentState_.heading = std::atan2(
+            points[1].y - points[0].y,
+            points[1].x - points[0].x);
+    }
     currentState_.velX = 0.0f;
     currentState_.velY = 0.0f;
-    currentState_.heading = 0.0f;
     currentState_.angularVel = 0.0f;
-    std::fill(currentState_.sensorReadings.begin(), currentState_.sensorReadings.end(), 0.0f);
+    currentState_.sensorReadings.fill(0.0f);
+    currentState_.sensorCount = config_.sensorCount;
     currentState_.leftMotor = 0.0f;
     currentState_.rightMotor = 0.0f;
     currentState_.lineError = 0.0f;
@@ -100,7 +242,47 @@ void Simulator::reset() {
     currentState_.time = 0.0f;
 }
 
-RobotState Simulator::getCurrentState() const {
+SimulatorSnapshot Simulator::saveState() const {
+    SimulatorSnapshot snapshot;
+    snapshot.state = currentState_;
+    snapshot.leftWheelSpeed = leftWheelSpeed_;
+    snapshot.rightWheelSpeed = rightWheelSpeed_;
+    snapshot.trackSegment = trackSegment_;
+    snapshot.simulationTime = simulationTime_;
+    snapshot.completionTime = completionTime_;
+    snapshot.prevError = prevError_;
+    snapshot.errorIntegral = errorIntegral_;
+    snapshot.relayOutput = relayOutput_;
+    snapshot.noiseState = noiseState_;
+    snapshot.monitor = monitor_;
+    snapshot.isComplete = isComplete_;
+    snapshot.hasFailed = hasFailed_;
+    return snapshot;
+}
+
+void Simulator::restoreState(const SimulatorSnapshot& snapshot) {
+    currentState_ = snapshot.state;
+    currentState_.sensorCount = config_.sensorCount;
+    leftWheelSpeed_ = snapshot.leftWheelSpeed;
+    rightWheelSpeed_ = snapshot.rightWheelSpeed;
+    trackSegment_ = Physics::clamp(snapshot.trackSegment, 0, track_->index().segmentCount() - 1);
+    simulationTime_ = snapshot.simulationTime;
+    completionTime_ = snapshot.completionTime;
+    prevError_ = snapshot.prevError;
+    errorIntegral_ = snapshot.errorIntegral;
+    relayOutput_ = snapshot.relayOutput;
+    noiseState_ = snapshot.noiseState;
+    monitor_ = snapshot.monitor;
+    isComplete_ = snapshot.isComplete;
+    hasFailed_ = snapshot.hasFailed;
+
+    // The warm start is not part of the snapshot; the next solve starts cold
+    if (mpc_) {
+        mpc_->reset();
+    }
+}
+
+const RobotState& Simulator::getCurrentState() const {
     return currentState_;
 }
 
@@ -112,10 +294,18 @@ bool Simulator::hasFailed() const {
     return hasFailed_;
 }
 
+FailureReason Simulator::getFailureReason() const {
+    return monitor_.reason;
+}
+
 float Simulator::getCompletionTime() const {
     return completionTime_;
 }
 
+void Simulator::setFailureCriteria(const FailureCriteria& criteria) {
+    failureCriteria_ = criteria;
+}
+
 void Simulator::updatePIDGains(float kp, float ki, float kd) {
     config_.kp = kp;
     config_.ki = ki;
@@ -126,11 +316,101 @@ void Simulator::updatePIDGains(float kp, float ki, float kd) {
     errorIntegral_ = 0.0f;
 }
 
+void Simulator::setDistanceField(float resolution, size_t memoryLimit) {
+    fieldResolution_ = resolution;
+    fieldMemoryLimit_ = memoryLimit;
+
+    distanceField_.reset();
+    if (resolution > 0.0f && track_) {
+        distanceField_ = std::make_unique<DistanceField>(
+            track_->index(), resolution, sensorRange_, memoryLimit);
+    }
+}
+
+void Simulator::setSensorNoise(float stddev, uint32_t seed) {
+    sensorNoise_ = std::max(0.0f, stddev);
+    noiseSeed_ = seed;
+    noiseState_ = Physics::noiseState(seed);
+}
+
+void Simulator::setRelayFeedback(float amplitude, float hysteresis) {
+    relayAmplitude_ = std::max(0.0f, amplitude);
+    relayHysteresis_ = std::max(0.0f, hysteresis);
+    relayOutput_ = 0.0f;
+}
+
+void Simulator::enableMPC(const Optimizers::MPCSettings& settings) {
+    float stallForce = Physics::MOTOR_STALL_TORQUE / (0.5f * config_.wheelDiameter);
+    mpc_ = std::make_unique<Optimizers::MPC>(
+        settings, config_.wheelbase, config_.maxSpeed, stallForce / (0.5f * config_.mass));
+    mpcStep_ = settings.horizonStep;
+    mpcFallbacks_ = 0;
+
+    mpcReference_ = std::make_unique<VelocityProfile>();
+    mpcReference_->compute(*track_, VelocityLimits::fromConfig(config_));
+}
+
+void Simulator::disableMPC() {
+    mpc_.reset();
+    mpcReference_.reset();
+}
+
+void Simulator::applyMPC(float& leftPower, float& rightPower) {
+    if (!mpc_) {
+        return;
+    }
+
+    // Pose error against the compiled sample nearest the robot's projection
+    int sample = track_->sampleAt(monitor_.progress);
+    float lineHeading = track_->heading()[sample];
+    float dx = currentState_.posX - track_->x()[sample];
+    float dy = currentState_.posY - track_->y()[sample];
+
+    Optimizers::MPCInput input;
+    input.lateralError = -std::sin(lineHeading) * dx + std::cos(lineHeading) * dy;
+    input.headingError = Physics::normalizeAngle(currentState_.heading - lineHeading);
+    input.leftSpeed = leftWheelSpeed_;
+    input.rightSpeed = rightWheelSpeed_;
+    input.leftCommand = currentState_.leftMotor;
+    input.rightCommand = currentState_.rightMotor;
+
+    // Preview along the line, advancing at the faster of the current and
+    // the reference speed so the horizon does not collapse from standstill
+    float arcLength = monitor_.progress;
+    float speed = 0.5f * (leftWheelSpeed_ + rightWheelSpeed_);
+    for (int k = 0; k < Optimizers::MPC_HORIZON; k++) {
+        float reference = mpcReference_->speedAt(arcLength);
+        arcLength = std::min(arcLength + mpcStep_ * std::max(speed, reference), track_->length());
+        input.curvature[k] = track_->curvatureAt(arcLength);
+        input.referenceSpeed[k] = mpcReference_->speedAt(arcLength);
+    }
+
+    if (!mpc_->solve(input, leftPower, rightPower)) {
+        mpcFallbacks_++;
+    }
+}
+
 void Simulator::updateSensors() {
-    // TODO: Implement actual sensor simulation with ray casting
-    // Placeholder: simulate some sensor readings
-    for (size_t i = 0; i < currentState_.sensorReadings.size(); i++) {
-        currentState_.sensorReadings[i] = 0.5f; // Neutral reading
+    // Sensors sit on a bar ahead of the axle, perpendicular to the heading.
+    // Sensor 0 is the leftmost one.
+    float c = std::cos(currentState_.heading);
+    float s = std::sin(currentState_.heading);
+    float barX = currentState_.posX + Physics::SENSOR_ARRAY_OFFSET * c;
+    float barY = currentState_.posY + Physics::SENSOR_ARRAY_OFFSET * s;
+    float center = 0.5f * static_cast<float>(config_.sensorCount - 1);
+
+    for (int i = 0; i < config_.sensorCount; i++) {
+        float lateral = (center - static_cast<float>(i)) * config_.sensorSpacing;
+        float sx = barX - s * lateral;
+        float sy = barY + c * lateral;
+        float distance = distanceField_
+            ? distanceField_->sample(sx, sy)
+            : track_->index().distance(sx, sy, sensorRange_);
+        float reading = Physics::sensorResponse(distance, config_.sensorHeight);
+        if (sensorNoise_ > 0.0f) {
+            reading = Physics::clamp(reading + sensorNoise_ * Physics::uniformNoise(noiseState_), 0.0f, 1.0f);
+        }
+        currentState_.sensorReadings[i] = reading;
     }
 }
 
@@ -151,42 +431,134 @@ float Simulator::calculatePID(float error, float dt) {
 }
 
 void Simulator::applyMotorCommands(float leftPower, float rightPower) {
-    // TODO: Apply forces/torques to Box2D body
     currentState_.leftMotor = leftPower;
     currentState_.rightMotor = rightPower;
 
-    // Calculate power consumption (simplified)
-    currentState_.power = (leftPower + rightPower) * 12.0f; // Assuming 12V system
+    // Electrical power: V * u * I, with current falling linearly with back-EMF
+    float leftCurrent = leftPower - leftWheelSpeed_ / config_.maxSpeed;
+    float rightCurrent = rightPower - rightWheelSpeed_ / config_.maxSpeed;
+    float load = std::max(0.0f, leftPower * leftCurrent) + std::max(0.0f, rightPower * rightCurrent);
+    currentState_.power = Physics::SUPPLY_VOLTAGE * Physics::MOTOR_STALL_CURRENT * load;
+}
+
+void Simulator::integrate(float dt) {
+    int substeps = std::max(1, static_cast<int>(std::ceil(dt / Physics::INTEGRATION_SUBSTEP)));
+    float h = dt / static_cast<float>(substeps);
+    float wheelMass = 0.5f * config_.mass;
+    float halfTrack = 0.5f * config_.wheelbase;
+
+    float heading = currentState_.heading;
+    float posX = currentState_.posX;
+    float posY = currentState_.posY;
+    float v = 0.0f;
+    float omega = 0.0f;
+
+    for (int i = 0; i < substeps; i++) {
+        leftWheelSpeed_ += h * Physics::motorAcceleration(
+            currentState_.leftMotor, leftWheelSpeed_, config_.maxSpeed,
+            stallForce_, wheelMass, traction_);
+        rightWheelSpeed_ += h * Physics::motorAcceleration(
+            currentState_.rightMotor, rightWheelSpeed_, config_.maxSpeed,
+            stallForce_, wheelMass, traction_);
+
+        v = 0.5f * (leftWheelSpeed_ + rightWheelSpeed_);
+        omega = (rightWheelSpeed_ - leftWheelSpeed_) / config_.wheelbase;
+
+        // Centripetal acceleration is limited by grip; excess yaw rate is lost
+        float lateral = std::abs(v * omega);
+        if (lateral > traction_) {
+            omega *= traction_ / lateral;
+            leftWheelSpeed_ = v - omega * halfTrack;
+            rightWheelSpeed_ = v + omega * halfTrack;
+        }
+
+        // Midpoint heading for the translation
+        float midHeading = heading + 0.5f * omega * h;
+        posX += v * std::cos(midHeading) * h;
+        posY += v * std::sin(midHeading) * h;
+        heading = Physics::normalizeAngle(heading + omega * h);
+    }
+
+    currentState_.posX = posX;
+    currentState_.posY = posY;
+    currentState_.heading = heading;
+    currentState_.velX = v * std::cos(heading);
+    currentState_.velY = v * std::sin(heading);
+    currentState_.angularVel = omega;
 }
 
 float Simulator::calculateLineError() {
-    // TODO: Calculate actual error based on sensor readings
-    // Placeholder: weighted sum of sensor readings
-    float error = 0.0f;
-    int centerIndex = config_.sensorCount / 2;
+    // Normalized centroid of the readings: -1 (line under leftmost sensor)
+    // to +1 (line under rightmost sensor)
+    float center = 0.5f * static_cast<float>(config_.sensorCount - 1);
+    float scale = center > 0.0f ? 1.0f / center : 0.0f;
+    float total = 0.0f;
+    float weighted = 0.0f;
 
     for (int i = 0; i < config_.sensorCount; i++) {
-        float weight = static_cast<float>(i - centerIndex);
-        error += weight * currentState_.sensorReadings[i];
+        float weight = (static_cast<float>(i) - center) * scale;
+        total += currentState_.sensorReadings[i];
+        weighted += weight * currentState_.sensorReadings[i];
+    }
+
+    float error;
+    if (total > LINE_LOST_THRESHOLD) {
+        error = weighted / total;
+    } else {
+        // Line lost: keep steering towards the side it was last seen
+        error = prevError_ >= 0.0f ? 1.0f : -1.0f;
     }
 
     currentState_.lineError = error;
     return error;
 }
 
+void Simulator::updateTrackProgress() {
+    trackSegment_ = track_->index().advanceCursor(
+        trackSegment_, currentState_.posX, currentState_.posY, PROGRESS_SEARCH_WINDOW);
+}
+
 void Simulator::checkCompletion() {
-    // TODO: Implement actual completion check
-    // For now, complete after 60 seconds
-    if (simulationTime_ > 60.0f && !isComplete_) {
+    // Complete once the robot passes the end of the final segment
+    int lastSegment = track_->index().segmentCount() - 1;
+    if (isComplete_ || trackSegment_ != lastSegment) {
+        return;
+    }
+
+    const TrackPoint& a = track_->points()[lastSegment];
+    const TrackPoint& b = track_->points()[lastSegment + 1];
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float along = (currentState_.posX - a.x) * dx + (currentState_.posY - a.y) * dy;
+
+    if (along >= dx * dx + dy * dy) {
         isComplete_ = true;
         completionTime_ = simulationTime_;
     }
 }
 
-void Simulator::checkFailure() {
-    // TODO: Implement failure detection (off track, collision, timeout)
-    // Placeholder: fail if timeout exceeds 120 seconds
-    if (simulationTime_ > 120.0f && !isComplete_) {
+void Simulator::checkFailure(float dt) {
+    if (isComplete_) {
+        return;
+    }
+
+    // Line outside the sensor array: farther from the bar centre than the
+    // outermost sensor plus half the line width
+    float c = std::cos(currentState_.heading);
+    float s = std::sin(currentState_.heading);
+    float barX = currentState_.posX + Physics::SENSOR_ARRAY_OFFSET * c;
+    float barY = currentState_.posY + Physics::SENSOR_ARRAY_OFFSET * s;
+    float offTrackDistance = 0.5f * static_cast<float>(config_.sensorCount - 1) * config_.sensorSpacing
+        + 0.5f * Physics::LINE_WIDTH;
+    float lineDistance = track_->index().distance(barX, barY, 2.0f * offTrackDistance);
+
+    float arcLength, alignment;
+    track_->index().project(trackSegment_, currentState_.posX, currentState_.posY, c, s, arcLength, alignment);
+
+    FailureReason reason = monitor_.update(
+        failureCriteria_, simulationTime_, dt, arcLength, track_->index().totalLength(),
+        lineDistance, offTrackDistance, alignment, config_.maxSpeed);
+    if (reason != FailureReason::NONE) {
         hasFailed_ = true;
     }
 }
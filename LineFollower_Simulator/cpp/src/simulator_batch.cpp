@@ -0,0 +1,378 @@
+/**
+ * @file simulator_batch.cpp
+ * @brief Implementation of structure-of-arrays batch simulator
+ */
+
+#include "../include/simulator_batch.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace LineFollower {
+
+SimulatorBatch::SimulatorBatch(const std::vector<RobotConfig>& configs, const std::vector<TrackPoint>& trackPoints)
+    : SimulatorBatch(configs, std::make_shared<const CompiledTrack>(trackPoints))
+{
+}
+
+SimulatorBatch::SimulatorBatch(const std::vector<RobotConfig>& configs, std::shared_ptr<const CompiledTrack> track)
+    : track_(std::move(track))
+    , fieldResolution_(0.0f)
+    , fieldMemoryLimit_(0)
+    , count_(static_cast<int>(configs.size()))
+    , running_(0)
+    , simulationTime_(0.0f)
+    , finishDistance_(0.0f)
+    , sensorNoise_(0.0f)
+    , noiseSeed_(0)
+    , failureCriteria_(FailureCriteria::defaults())
+{
+    size_t n = configs.size();
+    kp_.resize(n);
+    ki_.resize(n);
+    kd_.resize(n);
+    maxSpeed_.resize(n);
+    wheelbase_.resize(n);
+    wheelMass_.resize(n);
+    stallForce_.resize(n);
+    traction_.resize(n);
+    sensorSpacing_.resize(n);
+    sensorHeight_.resize(n);
+    sensorRange_.resize(n);
+    sensorCount_.resize(n);
+
+    for (size_t i = 0; i < n; i++) {
+        const RobotConfig& config = configs[i];
+        kp_[i] = config.kp;
+        ki_[i] = config.ki;
+        kd_[i] = config.kd;
+        maxSpeed_[i] = config.maxSpeed;
+        wheelbase_[i] = config.wheelbase;
+        wheelMass_[i] = 0.5f * config.mass;
+        stallForce_[i] = Physics::MOTOR_STALL_TORQUE / (0.5f * config.wheelDiameter);
+        float friction = Physics::adjustFrictionForTemperature(config.frictionCoeff, config.temperature);
+        traction_[i] = friction * config.gravity;
+        sensorSpacing_[i] = config.sensorSpacing;
+        sensorHeight_[i] = config.sensorHeight;
+        sensorRange_[i] = Physics::sensorRange(config.sensorHeight);
+        sensorCount_[i] = Physics::clamp(config.sensorCount, 1, MAX_SENSORS);
+    }
+
+    posX_.resize(n);
+    posY_.resize(n);
+    heading_.resize(n);
+    velocity_.resize(n);
+    angularVel_.resize(n);
+    leftWheelSpeed_.resize(n);
+    rightWheelSpeed_.resize(n);
+    leftMotor_.resize(n);
+    rightMotor_.resize(n);
+    power_.resize(n);
+    lineError_.resize(n);
+    sensorReadings_.resize(n * MAX_SENSORS);
+    trackSegment_.resize(n);
+    noiseState_.resize(n);
+    prevError_.resize(n);
+    errorIntegral_.resize(n);
+    monitors_.resize(n);
+    isComplete_.resize(n);
+    hasFailed_.resize(n);
+    completionTime_.resize(n);
+    elapsedTime_.resize(n);
+    trackError_.resize(n);
+    energy_.resize(n);
+    distance_.resize(n);
+}
+
+bool SimulatorBatch::initialize() {
+    if (!track_ || track_->index().segmentCount() < 1) {
+        return false;
+    }
+
+    setDistanceField(fieldResolution_, fieldMemoryLimit_);
+    reset();
+
+    return true;
+}
+
+void SimulatorBatch::setDistanceField(float resolution, size_t memoryLimit) {
+    fieldResolution_ = resolution;
+    fieldMemoryLimit_ = memoryLimit;
+
+    distanceField_.reset();
+    if (resolution > 0.0f && track_) {
+        // One field for the whole batch, clamped at the widest sensor range
+        float maxRange = 0.0f;
+        for (float range : sensorRange_) {
+            maxRange = std::max(maxRange, range);
+        }
+        distanceField_ = std::make_unique<DistanceField>(track_->index(), resolution, maxRange, memoryLimit);
+    }
+}
+
+void SimulatorBatch::setSensorNoise(float stddev, uint32_t seed) {
+    sensorNoise_ = std::max(0.0f, stddev);
+    noiseSeed_ = seed;
+    std::fill(noiseState_.begin(), noiseState_.end(), Physics::noiseState(seed));
+}
+
+void SimulatorBatch::reset() {
+    float startX = 0.0f;
+    float startY = 0.0f;
+    float startHeading = 0.0f;
+    if (track_ && track_->index().segmentCount() >= 1) {
+        const std::vector<TrackPoint>& points = track_->points();
+        startX = points[0].x;
+        startY = points[0].y;
+        startHeading = std::atan2(
+            points[1].y - points[0].y,
+            points[1].x - points[0].x);
+    }
+
+    std::fill(posX_.begin(), posX_.end(), startX);
+    std::fill(posY_.begin(), posY_.end(), startY);
+    std::fill(heading_.begin(), heading_.end(), startHeading);
+    std::fill(velocity_.begin(), velocity_.end(), 0.0f);
+    std::fill(angularVel_.begin(), angularVel_.end(), 0.0f);
+    std::fill(leftWheelSpeed_.begin(), leftWheelSpeed_.end(), 0.0f);
+    std::fill(rightWheelSpeed_.begin(), rightWheelSpeed_.end(), 0.0f);
+    std::fill(leftMotor_.begin(), leftMotor_.end(), 0.0f);
+    std::fill(rightMotor_.begin(), rightMotor_.end(), 0.0f);
+    std::fill(power_.begin(), power_.end(), 0.0f);
+    std::fill(lineError_.begin(), lineError_.end(), 0.0f);
+    std::fill(sensorReadings_.begin(), sensorReadings_.end(), 0.0f);
+    std::fill(trackSegment_.begin(), trackSegment_.end(), 0);
+    std::fill(noiseState_.begin(), noiseState_.end(), Physics::noiseState(noiseSeed_));
+    std::fill(prevError_.begin(), prevError_.end(), 0.0f);
+    std::fill(errorIntegral_.begin(), errorIntegral_.end(), 0.0f);
+    for (ProgressMonitor& monitor : monitors_) {
+        monitor.reset();
+    }
+    std::fill(isComplete_.begin(), isComplete_.end(), 0);
+    std::fill(hasFailed_.begin(), hasFailed_.end(), 0);
+    std::fill(completionTime_.begin(), completionTime_.end(), -1.0f);
+    std::fill(elapsedTime_.begin(), elapsedTime_.end(), 0.0f);
+    std::fill(trackError_.begin(), trackError_.end(), 0.0f);
+    std::fill(energy_.begin(), energy_.end(), 0.0f);
+    std::fill(distance_.begin(), distance_.end(), 0.0f);
+
+    simulationTime_ = 0.0f;
+    running_ = count_;
+}
+
+void SimulatorBatch::step(float dt) {
+    if (running_ == 0) {
+        return;
+    }
+
+    updateSensors();
+    updateControl(dt);
+    integrate(dt);
+    simulationTime_ += dt;
+    updateOutcome(dt);
+}
+
+void SimulatorBatch::updateSensors() {
+    for (int r = 0; r < count_; r++) {
+        if (!isRunning(r)) {
+            continue;
+        }
+
+        // Same sensor bar geometry as Simulator::updateSensors
+        float c = std::cos(heading_[r]);
+        float s = std::sin(heading_[r]);
+        float barX = posX_[r] + Physics::SENSOR_ARRAY_OFFSET * c;
+        float barY = posY_[r] + Physics::SENSOR_ARRAY_OFFSET * s;
+        int sensorCount = sensorCount_[r];
+        float center = 0.5f * static_cast<float>(sensorCount - 1);
+        float scale = center > 0.0f ? 1.0f / center : 0.0f;
+        float* readings = &sensorReadings_[r * MAX_SENSORS];
+        float total = 0.0f;
+        float weighted = 0.0f;
+
+        for (int i = 0; i < sensorCount; i++) {
+            float lateral = (center - static_cast<float>(i)) * sensorSpacing_[r];
+            float sx = barX - s * lateral;
+            float sy = barY + c * lateral;
+            float distance = distanceField_
+                ? distanceField_->sample(sx, sy)
+                : track_->index().distance(sx, sy, sensorRange_[r]);
+            readings[i] = Physics::sensorResponse(distance, sensorHeight_[r]);
+            if (sensorNoise_ > 0.0f) {
+                readings[i] = Physics::clamp(
+                    readings[i] + sensorNoise_ * Physics::uniformNoise(noiseState_[r]), 0.0f, 1.0f);
+            }
+
+            float weight = (static_cast<float>(i) - center) * scale;
+            total += readings[i];
+            weighted += weight * readings[i];
+        }
+
+        if (total > LINE_LOST_THRESHOLD) {
+            lineError_[r] = weighted / total;
+        } else {
+            lineError_[r] = prevError_[r] >= 0.0f ? 1.0f : -1.0f;
+        }
+    }
+}
+
+void SimulatorBatch::updateControl(float dt) {
+    const float* error = lineError_.data();
+    const float* kp = kp_.data();
+    const float* ki = ki_.data();
+    const float* kd = kd_.data();
+    const float* maxSpeed = maxSpeed_.data();
+    const float* leftSpeed = leftWheelSpeed_.data();
+    const float* rightSpeed = rightWheelSpeed_.data();
+    float* integral = errorIntegral_.data();
+    float* prevError = prevError_.data();
+    float* leftMotor = leftMotor_.data();
+    float* rightMotor = rightMotor_.data();
+    float* power = power_.data();
+    const uint8_t* complete = isComplete_.data();
+    const uint8_t* failed = hasFailed_.data();
+
+    // Branch-free over all robots; finished robots keep their final state
+    for (int r = 0; r < count_; r++) {
+        bool active = !(complete[r] | failed[r]);
+        float P = kp[r] * error[r];
+
+        float sum = Physics::clamp(integral[r] + error[r] * dt, -1.0f, 1.0f);
+        float I = ki[r] * sum;
+
+        float D = kd[r] * (error[r] - prevError[r]) / dt;
+
+        float control = P + I + D;
+        float left = Physics::clamp(control + BASE_POWER, 0.0f, 1.0f);
+        float right = Physics::clamp(-control + BASE_POWER, 0.0f, 1.0f);
+
+        float leftCurrent = left - leftSpeed[r] / maxSpeed[r];
+        float rightCurrent = right - rightSpeed[r] / maxSpeed[r];
+        float load = std::max(0.0f, left * leftCurrent) + std::max(0.0f, right * rightCurrent);
+
+        integral[r] = active ? sum : integral[r];
+        prevError[r] = active ? error[r] : prevError[r];
+        leftMotor[r] = active ? left : leftMotor[r];
+        rightMotor[r] = active ? right : rightMotor[r];
+        power[r] = active ? Physics::SUPPLY_VOLTAGE * Physics::MOTOR_STALL_CURRENT * load : power[r];
+    }
+}
+
+void SimulatorBatch::integrate(float dt) {
+    int substeps = std::max(1, static_cast<int>(std::ceil(dt / Physics::INTEGRATION_SUBSTEP)));
+    float h = dt / static_cast<float>(substeps);
+
+    const float* leftMotor = leftMotor_.data();
+    const float* rightMotor = rightMotor_.data();
+    const float* maxSpeed = maxSpeed_.data();
+    const float* stallForce = stallForce_.data();
+    const float* wheelMass = wheelMass_.data();
+    const float* traction = traction_.data();
+    const float* wheelbase = wheelbase_.data();
+    float* leftSpeed = leftWheelSpeed_.data();
+    float* rightSpeed = rightWheelSpeed_.data();
+    float* posX = posX_.data();
+    float* posY = posY_.data();
+    float* heading = heading_.data();
+    float* velocity = velocity_.data();
+    float* angularVel = angularVel_.data();
+    const uint8_t* complete = isComplete_.data();
+    const uint8_t* failed = hasFailed_.data();
+
+    for (int k = 0; k < substeps; k++) {
+        for (int r = 0; r < count_; r++) {
+            bool active = !(complete[r] | failed[r]);
+            float left = leftSpeed[r] + h * Physics::motorAcceleration(
+                leftMotor[r], leftSpeed[r], maxSpeed[r], stallForce[r], wheelMass[r], traction[r]);
+            float right = rightSpeed[r] + h * Physics::motorAcceleration(
+                rightMotor[r], rightSpeed[r], maxSpeed[r], stallForce[r], wheelMass[r], traction[r]);
+
+            float v = 0.5f * (left + right);
+            float omega = (right - left) / wheelbase[r];
+
+            float lateral = std::abs(v * omega);
+            if (lateral > traction[r]) {
+                float halfTrack = 0.5f * wheelbase[r];
+                omega *= traction[r] / lateral;
+                left = v - omega * halfTrack;
+                right = v + omega * halfTrack;
+            }
+
+            // Finished robots stay where they stopped
+            float midHeading = heading[r] + 0.5f * omega * h;
+            posX[r] = active ? posX[r] + v * std::cos(midHeading) * h : posX[r];
+            posY[r] = active ? posY[r] + v * std::sin(midHeading) * h : posY[r];
+            heading[r] = active ? Physics::normalizeAngle(heading[r] + omega * h) : heading[r];
+
+            leftSpeed[r] = active ? left : leftSpeed[r];
+            rightSpeed[r] = active ? right : rightSpeed[r];
+            velocity[r] = active ? v : velocity[r];
+            angularVel[r] = active ? omega : angularVel[r];
+        }
+    }
+}
+
+void SimulatorBatch::updateOutcome(float dt) {
+    int lastSegment = track_->index().segmentCount() - 1;
+    const std::vector<TrackPoint>& points = track_->points();
+
+    for (int r = 0; r < count_; r++) {
+        if (!isRunning(r)) {
+            continue;
+        }
+
+        elapsedTime_[r] = simulationTime_;
+        trackError_[r] += std::abs(lineError_[r]) * dt;
+        energy_[r] += power_[r] * dt;
+        distance_[r] += std::abs(velocity_[r]) * dt;
+
+        trackSegment_[r] = track_->index().advanceCursor(
+            trackSegment_[r], posX_[r], posY_[r], PROGRESS_SEARCH_WINDOW);
+
+        // Completion once past the end of the final segment
+        if (trackSegment_[r] == lastSegment) {
+            const TrackPoint& a = points[lastSegment];
+            const TrackPoint& b = points[lastSegment + 1];
+            float dx = b.x - a.x;
+            float dy = b.y - a.y;
+            float along = (posX_[r] - a.x) * dx + (posY_[r] - a.y) * dy;
+            if (along >= dx * dx + dy * dy) {
+                isComplete_[r] = 1;
+                completionTime_[r] = simulationTime_;
+                running_--;
+                continue;
+            }
+        }
+
+        // Same early-abort checks as Simulator::checkFailure
+        float c = std::cos(heading_[r]);
+        float s = std::sin(heading_[r]);
+        float barX = posX_[r] + Physics::SENSOR_ARRAY_OFFSET * c;
+        float barY = posY_[r] + Physics::SENSOR_ARRAY_OFFSET * s;
+        float offTrackDistance = 0.5f * static_cast<float>(sensorCount_[r] - 1) * sensorSpacing_[r]
+            + 0.5f * Physics::LINE_WIDTH;
+        float lineDistance = track_->index().distance(barX, barY, 2.0f * offTrackDistance);
+
+        float arcLength, alignment;
+        track_->index().project(trackSegment_[r], posX_[r], posY_[r], c, s, arcLength, alignment);
+
+        FailureReason reason = monitors_[r].update(
+            failureCriteria_, simulationTime_, dt, arcLength, track_->index().totalLength(),
+            lineDistance, offTrackDistance, alignment, maxSpeed_[r]);
+        if (reason != FailureReason::NONE) {
+            hasFailed_[r] = 1;
+            running_--;
+            continue;
+        }
+
+        // A lap prefix counts as finished once covered
+        if (finishDistance_ > 0.0f && monitors_[r].progress >= finishDistance_) {
+            isComplete_[r] = 1;
+            completionTime_[r] = simulationTime_;
+            running_--;
+        }
+    }
+}
+
+} // namespace LineFollower
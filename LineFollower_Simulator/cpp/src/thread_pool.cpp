@@ -0,0 +1,175 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of work-stealing thread pool
+ */
+
+#include "../include/thread_pool.hpp"
+#include <algorithm>
+
+namespace LineFollower {
+
+namespace {
+
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+constexpr bool THREADS_AVAILABLE = false;
+#else
+constexpr bool THREADS_AVAILABLE = true;
+#endif
+
+} // namespace
+
+ThreadPool::ThreadPool(int threadCount)
+    : task_(nullptr)
+    , generation_(0)
+    , remaining_(0)
+    , active_(0)
+    , stopping_(false)
+{
+    if (threadCount <= 0) {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (!THREADS_AVAILABLE) {
+        threadCount = 1;
+    }
+    threadCount = std::max(1, threadCount);
+
+    for (int i = 0; i < threadCount; i++) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+    for (int i = 1; i < threadCount; i++) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (std::thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& task) {
+    if (count <= 0) {
+        return;
+    }
+    if (workers_.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    // Seed each queue with a contiguous block; stealing rebalances
+    int threads = size();
+    for (int q = 0; q < threads; q++) {
+        int begin = static_cast<int>(static_cast<long>(count) * q / threads);
+        int end = static_cast<int>(static_cast<long>(count) * (q + 1) / threads);
+        std::lock_guard<std::mutex> lock(queues_[q]->mutex);
+        for (int i = begin; i < end; i++) {
+            queues_[q]->items.push_back(i);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        remaining_ = count;
+        error_ = nullptr;
+        generation_++;
+    }
+    wake_.notify_all();
+
+    drain(0, task);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return remaining_ == 0 && active_ == 0; });
+        task_ = nullptr;
+        error = error_;
+        error_ = nullptr;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(int self) {
+    uint64_t seen = 0;
+    for (;;) {
+        const std::function<void(int)>* task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) {
+                return;
+            }
+            seen = generation_;
+            task = task_;
+            if (!task) {
+                continue;   // job already finished before this worker woke
+            }
+            active_++;
+        }
+
+        drain(self, *task);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            active_--;
+        }
+        done_.notify_all();
+    }
+}
+
+void ThreadPool::drain(int self, const std::function<void(int)>& task) {
+    int item;
+    int finished = 0;
+    while (take(self, item)) {
+        try {
+            task(item);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+        finished++;
+    }
+
+    if (finished > 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        remaining_ -= finished;
+    }
+}
+
+bool ThreadPool::take(int self, int& item) {
+    {
+        WorkQueue& own = *queues_[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.items.empty()) {
+            item = own.items.back();
+            own.items.pop_back();
+            return true;
+        }
+    }
+
+    int threads = size();
+    for (int offset = 1; offset < threads; offset++) {
+        WorkQueue& victim = *queues_[(self + offset) % threads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.items.empty()) {
+            item = victim.items.front();
+            victim.items.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace LineFollower
@@ -0,0 +1,226 @@
+/**
+ * @file track_index.cpp
+ * @brief Implementation of uniform-grid track segment index
+ */
+
+#include "../include/track_index.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LineFollower {
+
+namespace {
+
+// Default cell size bounds (meters)
+constexpr float MIN_CELL_SIZE = 0.05f;
+
+// Upper bound on grid cells; the cell size grows until the grid fits
+constexpr long MAX_CELLS = 1L << 20;
+
+} // namespace
+
+TrackIndex::TrackIndex()
+    : originX_(0.0f)
+    , originY_(0.0f)
+    , cellSize_(1.0f)
+    , invCellSize_(1.0f)
+    , cellsX_(0)
+    , cellsY_(0)
+{
+}
+
+void TrackIndex::build(const std::vector<TrackPoint>& trackPoints, float cellSize) {
+    points_ = trackPoints;
+    cumulativeLength_.assign(points_.size(), 0.0f);
+    cellStart_.clear();
+    cellSegments_.clear();
+    cellsX_ = 0;
+    cellsY_ = 0;
+
+    int segments = segmentCount();
+    if (segments < 1) {
+        return;
+    }
+
+    // Bounding box and arc length
+    float minX = points_[0].x, maxX = points_[0].x;
+    float minY = points_[0].y, maxY = points_[0].y;
+    for (int i = 0; i < segments; i++) {
+        const TrackPoint& b = points_[i + 1];
+        minX = std::min(minX, b.x);
+        maxX = std::max(maxX, b.x);
+        minY = std::min(minY, b.y);
+        maxY = std::max(maxY, b.y);
+        cumulativeLength_[i + 1] = cumulativeLength_[i] + Physics::distance(
+            Physics::Vec2(points_[i].x, points_[i].y), Physics::Vec2(b.x, b.y));
+    }
+    float trackLength = cumulativeLength_.back();
+
+    if (cellSize <= 0.0f) {
+        cellSize = std::max(2.0f * trackLength / static_cast<float>(segments), MIN_CELL_SIZE);
+    }
+
+    // Grow cells until the grid fits the budget
+    long cells;
+    do {
+        cellsX_ = static_cast<int>((maxX - minX) / cellSize) + 1;
+        cellsY_ = static_cast<int>((maxY - minY) / cellSize) + 1;
+        cells = static_cast<long>(cellsX_) * cellsY_;
+        if (cells > MAX_CELLS) {
+            cellSize *= 2.0f;
+        }
+    } while (cells > MAX_CELLS);
+
+    originX_ = minX;
+    originY_ = minY;
+    cellSize_ = cellSize;
+    invCellSize_ = 1.0f / cellSize;
+
+    // Each segment is listed in every cell its bounding box overlaps.
+    // First pass counts, second pass fills.
+    cellStart_.assign(cells + 1, 0);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < segments; i++) {
+            const TrackPoint& a = points_[i];
+            const TrackPoint& b = points_[i + 1];
+            int x0 = static_cast<int>((std::min(a.x, b.x) - originX_) * invCellSize_);
+            int x1 = static_cast<int>((std::max(a.x, b.x) - originX_) * invCellSize_);
+            int y0 = static_cast<int>((std::min(a.y, b.y) - originY_) * invCellSize_);
+            int y1 = static_cast<int>((std::max(a.y, b.y) - originY_) * invCellSize_);
+            x0 = std::min(x0, cellsX_ - 1);
+            y0 = std::min(y0, cellsY_ - 1);
+            x1 = std::min(x1, cellsX_ - 1);
+            y1 = std::min(y1, cellsY_ - 1);
+
+            for (int cy = y0; cy <= y1; cy++) {
+                for (int cx = x0; cx <= x1; cx++) {
+                    int cell = cy * cellsX_ + cx;
+                    if (pass == 0) {
+                        cellStart_[cell + 1]++;
+                    } else {
+                        cellSegments_[cellStart_[cell]++] = i;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (long c = 0; c < cells; c++) {
+                cellStart_[c + 1] += cellStart_[c];
+            }
+            cellSegments_.resize(cellStart_[cells]);
+        } else {
+            // Fill advanced each start to the next cell's start; shift back
+            for (long c = cells; c > 0; c--) {
+                cellStart_[c] = cellStart_[c - 1];
+            }
+            cellStart_[0] = 0;
+        }
+    }
+}
+
+float TrackIndex::nearest(float x, float y, float maxDistance, int& segment, float& t) const {
+    float bestSq = maxDistance * maxDistance;
+    segment = -1;
+    t = 0.0f;
+
+    if (cellsX_ == 0) {
+        return maxDistance;
+    }
+
+    float fx = Physics::clamp((x - originX_) * invCellSize_, -1e6f, 1e6f);
+    float fy = Physics::clamp((y - originY_) * invCellSize_, -1e6f, 1e6f);
+    int cx = static_cast<int>(std::floor(fx));
+    int cy = static_cast<int>(std::floor(fy));
+
+    // Rings grow outwards from the query cell; each ring only visits cells
+    // that intersect the bounding box of the current best distance
+    for (int ring = 0; ; ring++) {
+        float radius = std::sqrt(bestSq);
+        int colMin = std::max(static_cast<int>(std::floor(fx - radius * invCellSize_)), 0);
+        int colMax = std::min(static_cast<int>(std::floor(fx + radius * invCellSize_)), cellsX_ - 1);
+        int rowMin = std::max(static_cast<int>(std::floor(fy - radius * invCellSize_)), 0);
+        int rowMax = std::min(static_cast<int>(std::floor(fy + radius * invCellSize_)), cellsY_ - 1);
+
+        if (cx - ring < colMin && cx + ring > colMax && cy - ring < rowMin && cy + ring > rowMax) {
+            break;
+        }
+
+        for (int row = std::max(cy - ring, rowMin); row <= std::min(cy + ring, rowMax); row++) {
+            // Interior rows of the ring only touch its two side columns
+            bool edgeRow = (row == cy - ring || row == cy + ring);
+            int stride = edgeRow ? 1 : 2 * ring;
+
+            for (int col = cx - ring; col <= cx + ring; col += stride) {
+                if (col < colMin || col > colMax) {
+                    continue;
+                }
+                int cell = row * cellsX_ + col;
+                for (int k = cellStart_[cell]; k < cellStart_[cell + 1]; k++) {
+                    int i = cellSegments_[k];
+                    scanSegments(x, y, i, i, bestSq, segment, t);
+                }
+            }
+        }
+    }
+
+    return segment >= 0 ? std::sqrt(bestSq) : maxDistance;
+}
+
+float TrackIndex::distance(float x, float y, float maxDistance) const {
+    int segment;
+    float t;
+    return nearest(x, y, maxDistance, segment, t);
+}
+
+int TrackIndex::advanceCursor(int cursor, float x, float y, int window) const {
+    int end = std::min(cursor + window, segmentCount() - 1);
+    int result = cursor;
+    float best = 1e30f;
+    float t;
+
+    for (int i = cursor; i <= end; i++) {
+        const TrackPoint& a = points_[i];
+        const TrackPoint& b = points_[i + 1];
+        float d = Physics::pointSegmentDistanceSq(x, y, a.x, a.y, b.x, b.y, t);
+        if (d < best) {
+            best = d;
+            result = i;
+        }
+    }
+
+    return result;
+}
+
+void TrackIndex::project(int segment, float x, float y, float dirX, float dirY, float& arcLength, float& alignment) const {
+    const TrackPoint& a = points_[segment];
+    const TrackPoint& b = points_[segment + 1];
+    float t;
+    Physics::pointSegmentDistanceSq(x, y, a.x, a.y, b.x, b.y, t);
+    arcLength = this->arcLength(segment, t);
+
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    alignment = length > 1e-6f ? (dirX * dx + dirY * dy) / length : 1.0f;
+}
+
+void TrackIndex::scanSegments(float x, float y, int first, int last, float& bestSq, int& segment, float& t) const {
+    first = std::max(first, 0);
+    last = std::min(last, segmentCount() - 1);
+    float u;
+
+    for (int i = first; i <= last; i++) {
+        const TrackPoint& a = points_[i];
+        const TrackPoint& b = points_[i + 1];
+        float d = Physics::pointSegmentDistanceSq(x, y, a.x, a.y, b.x, b.y, u);
+        if (d < bestSq) {
+            bestSq = d;
+            segment = i;
+            t = u;
+        }
+    }
+}
+
+} // namespace LineFollower
@@ -0,0 +1,176 @@
+/**
+ * @file velocity_profile.cpp
+ * @brief Implementation of forward-backward speed profile
+ */
+
+#include "../include/velocity_profile.hpp"
+#include "../include/compiled_track.hpp"
+#include "../include/physics.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace LineFollower {
+
+namespace {
+
+// Curvature below this is treated as straight (1/m)
+constexpr float STRAIGHT_CURVATURE = 1e-4f;
+
+/**
+ * @brief Longitudinal acceleration left after cornering (friction circle)
+ * @param available Longitudinal limit ignoring cornering (m/s²)
+ * @param speed Current speed (m/s)
+ * @param curvature Absolute curvature (1/m)
+ * @param grip Total grip acceleration (m/s²)
+ */
+float frictionCircle(float available, float speed, float curvature, float grip) {
+    float lateral = speed * speed * curvature;
+    float ratio = grip > 0.0f ? lateral / grip : 1.0f;
+    float longitudinal = grip * std::sqrt(std::max(0.0f, 1.0f - ratio * ratio));
+    return std::min(available, longitudinal);
+}
+
+} // namespace
+
+VelocityLimits VelocityLimits::fromConfig(const RobotConfig& config) {
+    VelocityLimits limits;
+    limits.maxSpeed = config.maxSpeed;
+    limits.friction = Physics::adjustFrictionForTemperature(config.frictionCoeff, config.temperature);
+    limits.gravity = config.gravity;
+
+    // Both wheels at stall, as in the simulator's motor model
+    float stallForce = Physics::MOTOR_STALL_TORQUE / (0.5f * config.wheelDiameter);
+    float motorAcceleration = 2.0f * stallForce / config.mass;
+    float grip = limits.friction * limits.gravity;
+
+    limits.maxAcceleration = std::min(grip, motorAcceleration);
+    limits.maxDeceleration = std::min(grip, motorAcceleration);
+    limits.motorLimited = true;
+    return limits;
+}
+
+VelocityProfile::VelocityProfile()
+    : spacing_(0.0f)
+{
+}
+
+void VelocityProfile::compute(const CompiledTrack& track, const VelocityLimits& limits) {
+    compute(track.curvature(), track.spacing(), limits, 0.0f, -1.0f, false);
+}
+
+void VelocityProfile::compute(
+    const std::vector<float>& curvature,
+    float spacing,
+    const VelocityLimits& limits,
+    float entrySpeed,
+    float exitSpeed,
+    bool periodic)
+{
+    int n = static_cast<int>(curvature.size());
+    spacing_ = spacing;
+    speed_.assign(n, 0.0f);
+    time_.assign(n, 0.0f);
+    if (n < 2 || spacing <= 0.0f) {
+        return;
+    }
+
+    float grip = limits.friction * limits.gravity;
+
+    // Speed cap from grip and top speed
+    std::vector<float> limit(n);
+    for (int i = 0; i < n; i++) {
+        float k = std::abs(curvature[i]);
+        limit[i] = limits.maxSpeed;
+        if (k > STRAIGHT_CURVATURE) {
+            limit[i] = std::min(limit[i], Physics::optimalCurveSpeed(1.0f / k, limits.friction, limits.gravity));
+        }
+    }
+
+    auto accelerationAt = [&](float v, int i) {
+        float available = limits.maxAcceleration;
+        if (limits.motorLimited && limits.maxSpeed > 0.0f) {
+            available *= std::max(0.0f, 1.0f - v / limits.maxSpeed);
+        }
+        return frictionCircle(available, v, std::abs(curvature[i]), grip);
+    };
+    auto decelerationAt = [&](float v, int i) {
+        return frictionCircle(limits.maxDeceleration, v, std::abs(curvature[i]), grip);
+    };
+
+    // Loop samples: the last one repeats the first on periodic profiles
+    int count = periodic ? n - 1 : n;
+    int start = 0;
+    if (periodic) {
+        // Start both sweeps at the tightest point, whose cap is reachable
+        start = static_cast<int>(std::min_element(limit.begin(), limit.begin() + count) - limit.begin());
+    }
+
+    // Forward pass: accelerate as hard as allowed
+    std::vector<float> forward(limit);
+    if (!periodic && entrySpeed >= 0.0f) {
+        forward[0] = std::min(forward[0], entrySpeed);
+    }
+    for (int step = 0; step + 1 < count + (periodic ? 1 : 0); step++) {
+        int i = (start + step) % count;
+        int next = (start + step + 1) % count;
+        float v = forward[i];
+        float reachable = std::sqrt(v * v + 2.0f * accelerationAt(v, i) * spacing);
+        forward[next] = std::min(forward[next], reachable);
+    }
+
+    // Backward pass: brake as late as allowed
+    speed_ = forward;
+    if (!periodic && exitSpeed >= 0.0f) {
+        speed_[n - 1] = std::min(speed_[n - 1], exitSpeed);
+    }
+    for (int step = 0; step + 1 < count + (periodic ? 1 : 0); step++) {
+        int i = ((start - step) % count + count) % count;
+        int previous = ((start - step - 1) % count + count) % count;
+        float v = speed_[i];
+        float reachable = std::sqrt(v * v + 2.0f * decelerationAt(v, i) * spacing);
+        speed_[previous] = std::min(speed_[previous], reachable);
+    }
+    if (periodic) {
+        speed_[n - 1] = speed_[0];
+    }
+
+    // Time by trapezoidal speed between samples
+    for (int i = 0; i + 1 < n; i++) {
+        float mean = 0.5f * (speed_[i] + speed_[i + 1]);
+        time_[i + 1] = time_[i] + (mean > 0.0f ? spacing / mean : 0.0f);
+    }
+}
+
+float VelocityProfile::position(float arcLength, int& sample) const {
+    int n = static_cast<int>(speed_.size());
+    if (n < 2 || spacing_ <= 0.0f) {
+        sample = 0;
+        return 0.0f;
+    }
+    float u = Physics::clamp(arcLength / spacing_, 0.0f, static_cast<float>(n - 1));
+    sample = std::min(static_cast<int>(u), n - 2);
+    return u - static_cast<float>(sample);
+}
+
+float VelocityProfile::speedAt(float arcLength) const {
+    if (speed_.empty()) {
+        return 0.0f;
+    }
+    int sample;
+    float t = position(arcLength, sample);
+    if (speed_.size() < 2) {
+        return speed_[0];
+    }
+    return Physics::lerp(speed_[sample], speed_[sample + 1], t);
+}
+
+float VelocityProfile::remainingTime(float arcLength) const {
+    if (time_.size() < 2) {
+        return 0.0f;
+    }
+    int sample;
+    float t = position(arcLength, sample);
+    return lapTime() - Physics::lerp(time_[sample], time_[sample + 1], t);
+}
+
+} // namespace LineFollower